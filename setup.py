@@ -18,12 +18,10 @@
 # 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
 
 try:
-    from setuptools import setup
+    from setuptools import setup, Extension
 
 except ImportError:
-    from distutils.core import setup
-
-from distutils.core import Extension
+    from distutils.core import setup, Extension
 
 setup(
     name = "dateblock",
@@ -34,7 +32,7 @@ setup(
     author='Chris Caron',
     author_email='lead2gold@gmail.com',
     license="GPLv2",
-    classifiers=(
+    classifiers=[
                 'Development Status :: 5 - Production/Stable',
                 'Intended Audience :: Developers',
                 'Operating System :: POSIX :: Linux',
@@ -42,11 +40,17 @@ setup(
                 'Programming Language :: C++',
                 'Programming Language :: Python',
                 'Programming Language :: Python :: 2.7',
+                'Programming Language :: Python :: 3',
                 'License :: OSI Approved :: GNU General Public License v2 (GPLv2)',
-            ),
+            ],
     ext_modules = [
         Extension("dateblock", [
             "src/Date.cpp",
+            "src/DateFormat.cpp",
+            "src/CronSchedule.cpp",
+            "src/CronCache.cpp",
+            "src/DateBatch.cpp",
+            "src/TimeZone.cpp",
             "src/dateblock.cpp",
         ],
         libraries=['stdc++'],
@@ -0,0 +1,182 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _CALENDAR_H
+#define _CALENDAR_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <stdint.h>
+
+// Proleptic Gregorian calendar arithmetic.  Nothing in here knows anything
+// about timezones; a 'local' time is simply the number of seconds since
+// 1970-01-01 00:00:00 as it would appear on a wall clock.  Converting to
+// and from a real moment in time (time_t) only requires the UTC offset.
+//
+// The days from/to civil conversions are Howard Hinnant's algorithms; they
+// are exact for every date a 64-bit count of days can hold.
+class Calendar
+{
+   public:
+     static const int64_t SECS_PER_MIN = 60;
+     static const int64_t SECS_PER_HOUR = 3600;
+     static const int64_t SECS_PER_DAY = 86400;
+
+     // Returns true if the year specified is a leap year
+     static bool IsLeap(const int64_t year);
+
+     // Returns the number of days (28-31) in the month (1-12) specified
+     static int DaysInMonth(const int64_t year, const int month);
+
+     // Returns the number of days since 1970-01-01 for the year, month
+     // (1-12) and day of month specified.  The day of month may fall
+     // outside of the month (the 32nd of January is the 1st of February).
+     static int64_t DaysFromCivil(int64_t year, const int month,
+                                  const int dom);
+
+     // The inverse of DaysFromCivil()
+     static void CivilFromDays(int64_t days,
+                               int &year, int &month, int &dom);
+
+     // Returns the day of the week (0-6) {Sun=0,...,Sat=6}
+     static int WeekDay(const int64_t days);
+
+     // Returns the day of the year (0-365); Jan 1st = 0
+     static int DayOfYear(const int64_t year, const int month, const int dom);
+
+     // Rounds towards negative infinity (unlike '/')
+     static int64_t FloorDiv(const int64_t num, const int64_t den);
+
+     // Moves the year and month (1-12) on by the number of months
+     // specified (which may be negative) in constant time
+     static void AddMonths(int64_t &year, int &month, const int64_t months);
+
+     // Returns the local seconds since the epoch; every field (including
+     // the month) may be out of its normal range and is carried into the
+     // field above it.
+     static int64_t ToSeconds(int64_t year, int64_t month, int64_t dom,
+                              int64_t hour, int64_t min, int64_t sec);
+
+     // Breaks local seconds down into a struct tm (tm_isdst is left as -1)
+     static void FromSeconds(const int64_t secs, struct tm &tmOut);
+};
+
+inline bool Calendar::IsLeap(const int64_t year)
+{
+   return (year % 4 == 0) && (year % 100 != 0 || year % 400 == 0);
+}
+
+inline int Calendar::DaysInMonth(const int64_t year, const int month)
+{
+   if(month == 2)
+      return IsLeap(year) ? 29 : 28;
+
+   // 31 days on odd months until August where it flips to even ones
+   return 30 + ((month + (month >> 3)) & 1);
+}
+
+inline int64_t Calendar::DaysFromCivil(int64_t year, const int month,
+                                       const int dom)
+{
+   year -= (month <= 2);
+   const int64_t era = (year >= 0 ? year : year - 399) / 400;
+   const int64_t yoe = year - era * 400;
+   const int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 +
+                       dom - 1;
+   const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+   return era * 146097 + doe - 719468;
+}
+
+inline void Calendar::CivilFromDays(int64_t days,
+                                    int &year, int &month, int &dom)
+{
+   days += 719468;
+   const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+   const int64_t doe = days - era * 146097;
+   const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+   const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+   const int64_t mp = (5 * doy + 2) / 153;
+   dom = (int)(doy - (153 * mp + 2) / 5 + 1);
+   month = (int)(mp < 10 ? mp + 3 : mp - 9);
+   year = (int)(yoe + era * 400 + (month <= 2));
+}
+
+inline int Calendar::WeekDay(const int64_t days)
+{
+   // 1970-01-01 was a Thursday
+   return (int)((days % 7 + 11) % 7);
+}
+
+inline int Calendar::DayOfYear(const int64_t year, const int month,
+                               const int dom)
+{
+   if(month <= 2)
+      return (month - 1) * 31 + dom - 1;
+
+   // March onwards follows the same 153 day / 5 month cycle DaysFromCivil()
+   // uses
+   return (153 * (month - 3) + 2) / 5 + 59 + IsLeap(year) + dom - 1;
+}
+
+inline int64_t Calendar::FloorDiv(const int64_t num, const int64_t den)
+{
+   return (num >= 0) ? (num / den) : -((-num + den - 1) / den);
+}
+
+inline void Calendar::AddMonths(int64_t &year, int &month,
+                                const int64_t months)
+{
+   // Count the months from year 0 then split them back up again
+   const int64_t total = year * 12 + (month - 1) + months;
+   year = FloorDiv(total, 12);
+   month = (int)(total - year * 12) + 1;
+}
+
+inline int64_t Calendar::ToSeconds(int64_t year, int64_t month, int64_t dom,
+                                   int64_t hour, int64_t min, int64_t sec)
+{
+   // Carry the month into the year so it is always between 1 and 12
+   int64_t years = FloorDiv(month - 1, 12);
+   year += years;
+   month -= years * 12;
+
+   return (DaysFromCivil(year, (int)month, 1) + dom - 1) * SECS_PER_DAY +
+          hour * SECS_PER_HOUR + min * SECS_PER_MIN + sec;
+}
+
+inline void Calendar::FromSeconds(const int64_t secs, struct tm &tmOut)
+{
+   const int64_t days = FloorDiv(secs, SECS_PER_DAY);
+   const int daySecs = (int)(secs - days * SECS_PER_DAY);
+   int year, month, dom;
+
+   CivilFromDays(days, year, month, dom);
+   tmOut.tm_year = year - 1900;
+   tmOut.tm_mon = month - 1;
+   tmOut.tm_mday = dom;
+   tmOut.tm_hour = daySecs / 3600;
+   tmOut.tm_min = (daySecs / 60) % 60;
+   tmOut.tm_sec = daySecs % 60;
+   tmOut.tm_wday = WeekDay(days);
+   tmOut.tm_yday = DayOfYear(year, month, dom);
+   tmOut.tm_isdst = -1;
+}
+#endif
@@ -0,0 +1,173 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <pthread.h>
+#include "CronCache.h"
+
+using namespace std;
+
+namespace {
+   // Holds a mutex for as long as it is in scope
+   class CacheLock
+   {
+      public:
+        explicit CacheLock(pthread_mutex_t &mutex) : m_mutex(mutex)
+        {
+           pthread_mutex_lock(&m_mutex);
+        }
+        ~CacheLock()
+        {
+           pthread_mutex_unlock(&m_mutex);
+        }
+
+      private:
+        pthread_mutex_t &m_mutex;
+   };
+}
+
+//------------------------------------------------
+//
+//  Function: Constructor
+//
+//------------------------------------------------
+CronCache::CronCache(const size_t capacity)
+   : m_capacity(capacity > 0 ? capacity : 1), m_hits(0), m_misses(0)
+{
+   pthread_mutex_init(&m_mutex, NULL);
+}
+
+//------------------------------------------------
+//
+//  Function: Deconstructor
+//
+//------------------------------------------------
+CronCache::~CronCache()
+{
+   pthread_mutex_destroy(&m_mutex);
+}
+
+//------------------------------------------------
+//
+//  Function: Global
+//
+//------------------------------------------------
+CronCache& CronCache::Global()
+{
+   static CronCache cache;
+   return cache;
+}
+
+//------------------------------------------------
+//
+//  Function: Lookup
+//
+//------------------------------------------------
+const CronSchedule CronCache::Lookup(const string& sCronStr, bool isISC)
+{
+   const CacheKey key(sCronStr, isISC);
+   {
+      CacheLock lock(m_mutex);
+      CacheIndex::iterator itr = m_index.find(key);
+      if(itr != m_index.end())
+      {
+         // Move it to the front of the line
+         m_entries.splice(m_entries.begin(), m_entries, itr->second);
+         m_hits++;
+         return itr->second->second;
+      }
+      m_misses++;
+   }
+
+   // Compile it without holding the lock; two threads may race to compile
+   // the same string but they'll come up with the same result
+   const CronSchedule schedule(sCronStr, isISC);
+
+   CacheLock lock(m_mutex);
+   if(m_index.find(key) == m_index.end())
+   {
+      if(m_entries.size() >= m_capacity)
+      {
+         // Make room by dropping the least recently used entry
+         m_index.erase(m_entries.back().first);
+         m_entries.pop_back();
+      }
+      m_entries.push_front(make_pair(key, schedule));
+      m_index[key] = m_entries.begin();
+   }
+   return schedule;
+}
+
+//------------------------------------------------
+//
+//  Function: Clear
+//
+//------------------------------------------------
+void CronCache::Clear()
+{
+   CacheLock lock(m_mutex);
+   m_entries.clear();
+   m_index.clear();
+   m_hits = m_misses = 0;
+}
+
+//------------------------------------------------
+//
+//  Function: Hits
+//
+//------------------------------------------------
+const unsigned long CronCache::Hits() const
+{
+   CacheLock lock(m_mutex);
+   return m_hits;
+}
+
+//------------------------------------------------
+//
+//  Function: Misses
+//
+//------------------------------------------------
+const unsigned long CronCache::Misses() const
+{
+   CacheLock lock(m_mutex);
+   return m_misses;
+}
+
+//------------------------------------------------
+//
+//  Function: Size
+//
+//------------------------------------------------
+const size_t CronCache::Size() const
+{
+   CacheLock lock(m_mutex);
+   return m_entries.size();
+}
+
+//------------------------------------------------
+//
+//  Function: Capacity
+//
+//------------------------------------------------
+const size_t CronCache::Capacity() const
+{
+   return m_capacity;
+}
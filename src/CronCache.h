@@ -0,0 +1,81 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _CRON_CACHE_H
+#define _CRON_CACHE_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <pthread.h>
+#include <string>
+#include <list>
+#include <map>
+#include "CronSchedule.h"
+
+using namespace std;
+
+// A bounded cache of compiled cron strings; once it is full, the entry that
+// was used the longest time ago makes room for a new one.  Every method is
+// safe to call from any number of threads at once.
+class CronCache
+{
+   public:
+     // The number of cron strings the global cache holds
+     static const size_t DEFAULT_CAPACITY = 1024;
+
+     explicit CronCache(const size_t capacity = DEFAULT_CAPACITY);
+     ~CronCache();
+
+     // Returns the compiled schedule for the cron string specified; it is
+     // only compiled if it isn't already in the cache.  Cron strings that
+     // fail to compile are cached too (as an invalid schedule).
+     const CronSchedule Lookup(const string& sCronStr, bool isISC = false);
+
+     // Drops every entry (the counters are reset too)
+     void Clear();
+
+     const unsigned long Hits() const;
+     const unsigned long Misses() const;
+     const size_t Size() const;
+     const size_t Capacity() const;
+
+     // The cache shared by Date::Cron() and friends
+     static CronCache& Global();
+
+   private:
+     typedef pair<string, bool> CacheKey;
+     typedef list<pair<CacheKey, CronSchedule> > CacheList;
+     typedef map<CacheKey, CacheList::iterator> CacheIndex;
+
+     // Most recently used entries are at the front
+     CacheList m_entries;
+     CacheIndex m_index;
+     size_t m_capacity;
+
+     unsigned long m_hits;
+     unsigned long m_misses;
+
+     mutable pthread_mutex_t m_mutex;
+
+     // Not copyable
+     CronCache(const CronCache&);
+     const CronCache& operator=(const CronCache&);
+};
+#endif
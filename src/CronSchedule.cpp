@@ -0,0 +1,1210 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <limits>
+#include "Date.h"
+#include "CronSchedule.h"
+#include "Calendar.h"
+#include "DateBatch.h"
+#include "TimeZone.h"
+
+using namespace std;
+
+namespace {
+   // The number of years we're willing to search before giving up; the
+   // Gregorian calendar repeats itself every 400 years so there is no
+   // point in looking any further then this.
+   const int CRON_YEAR_SPAN = 400;
+
+   // The number of fields (second through to drift) a schedule is made of
+   const int CRON_FIELD_COUNT = 7;
+
+   // How far ahead (in seconds) a series looks for timezone transitions
+   // each time it has to look for one
+   const time_t CRON_SEGMENT_SPAN = 2678400;
+
+   // Every 7th day of a month (bits 0, 7, 14, 21 and 28)
+   const uint64_t WEEKLY_DAYS = 0x10204081ULL;
+
+   // Maximum number of days in each month (a leap year is assumed)
+   const int MaxDOMs[12] = {31,29,31,30,31,30,31,31,30,31,30,31};
+
+#ifdef CRON_ASSERT_LOOP_LIMIT
+   // Each pass of a search crosses a timezone transition (there are only
+   // ever a handful between two matches); if we find ourselves looping more
+   // then this then something is wrong with the system's timezone data.
+   void AssertLoopLimit(unsigned &limit, const time_t tRef)
+   {
+      if(limit == 0)
+      {
+         cerr << "FATAL:"
+              << " CRON_ASSERT_LOOP_LIMIT ("
+              << CRON_ASSERT_LOOP_LIMIT
+              << ") reached."
+              << " REF=" << tRef
+              << endl;
+         // Fail; there is a system problem!
+         exit(1);
+      }
+      limit--;
+   }
+#endif
+
+   // The number of moments in time MatchMask() tests at a time (a multiple
+   // of 64 so each block fills whole words of the mask)
+   const size_t MATCH_BLOCK = 1024;
+
+   // A block of moments in time broken down into local time along with
+   // the result of testing them; keeping every array in one structure lets
+   // the compiler see that none of them overlap
+   struct MatchBlock
+   {
+      int month[MATCH_BLOCK];
+      int dom[MATCH_BLOCK];
+      int hour[MATCH_BLOCK];
+      int min[MATCH_BLOCK];
+      int sec[MATCH_BLOCK];
+      int dow[MATCH_BLOCK];
+      uint32_t hit[MATCH_BLOCK];
+   };
+
+   // The bitmask of each field; the seconds and minutes are split in two
+   // so every mask is 32 bits wide
+   struct MatchMasks
+   {
+      uint32_t secLo;
+      uint32_t secHi;
+      uint32_t minLo;
+      uint32_t minHi;
+      uint32_t hour;
+      uint32_t dom;
+      uint32_t month;
+      uint32_t dow;
+   };
+
+   //------------------------------------------------
+   //
+   //  Function: MatchKernel
+   //  (sets hit[n] if the fields of date n match)
+   //
+   //------------------------------------------------
+   BATCH_KERNEL void MatchKernel(MatchBlock &block, const MatchMasks& masks,
+                                 const size_t count)
+   {
+      const MatchMasks m = masks;
+      for(size_t index = 0; index < count; index++)
+      {
+         const uint32_t sec = (uint32_t)block.sec[index];
+         const uint32_t min = (uint32_t)block.min[index];
+         const uint32_t secMask = (sec & 32) ? m.secHi : m.secLo;
+         const uint32_t minMask = (min & 32) ? m.minHi : m.minLo;
+
+         block.hit[index] |= (secMask >> (sec & 31)) &
+                             (minMask >> (min & 31)) &
+                             (m.hour >> block.hour[index]) &
+                             (m.dom >> block.dom[index]) &
+                             (m.month >> block.month[index]) &
+                             (m.dow >> block.dow[index]) & 1;
+      }
+   }
+
+   // The characters that separate the fields of a cron string
+   inline bool IsSpace(const char ch)
+   {
+      return ch == ' ' || ch == '\t' || ch == '\n' ||
+             ch == '\r' || ch == '\v' || ch == '\f';
+   }
+
+   // Converts the digits between szBegin and szEnd into valOut; returns
+   // false if there are none or the value falls outside of minVal and
+   // maxVal.
+   bool ParseNumber(const char* szBegin, const char* szEnd,
+                    int &valOut, int minVal, int maxVal)
+   {
+      if(szBegin == szEnd)
+         return false;
+
+      int64_t val = 0;
+      for(; szBegin < szEnd; szBegin++)
+      {
+         val = val * 10 + (*szBegin - '0');
+         if(val > maxVal)
+            return false;
+      }
+
+      if(val < minVal)
+         return false;
+
+      valOut = (int)val;
+      return true;
+   }
+
+   // Parses a single cron field (the characters between szBegin and szEnd)
+   // into the field object specified (a CronField or CronDrift) in a single
+   // pass; a field that is left empty ('*') permits nothing at all.
+   // Returns NULL if it was parsed successfully, otherwise a pointer to the
+   // character that couldn't be.
+   template <class Field>
+   const char* ParseField(const char* szBegin, const char* szEnd,
+                          Field &fieldOut, int minVal, int maxVal)
+   {
+      // Valid characters are:
+      //   0-9,-/*
+      //
+      // A range (-) or step (/) that isn't finished by the time a comma is
+      // reached carries on into the next entry (so '1-,5' is '1-5').
+      const char* szNum = szBegin;
+      int rangeStart = -1;
+      bool modFlag = false;
+      int val;
+
+      for(const char* szPos = szBegin; ; szPos++)
+      {
+         if(szPos < szEnd && *szPos >= '0' && *szPos <= '9')
+            continue;
+
+         if(szPos == szEnd || *szPos == ',')
+         {
+            // The end of an entry; store the number that finishes it
+            if(szPos > szNum)
+            {
+               if(!ParseNumber(szNum, szPos, val, minVal, maxVal))
+                  return szNum;
+
+               if(modFlag)
+               {
+                  // Calculate Mod
+                  if(val == 0)
+                     return szNum;
+
+                  for(int64_t newVal = 0; newVal <= maxVal; newVal += val)
+                  {
+                     if(newVal < minVal)
+                        continue;
+                     if(!fieldOut.Set((int)newVal))
+                        return szNum;
+                  }
+                  modFlag = false;
+               }
+               else if(rangeStart < 0)
+               {
+                  if(!fieldOut.Set(val))
+                     return szNum;
+               }
+               else
+               {
+                  if(rangeStart > val)
+                  {
+                     // Swap
+                     int tmp = rangeStart;
+                     rangeStart = val;
+                     val = tmp;
+                  }
+
+                  for(; rangeStart <= val; rangeStart++)
+                     if(!fieldOut.Set(rangeStart))
+                        return szNum;
+
+                  rangeStart = -1;
+               }
+            }
+
+            if(szPos == szEnd)
+               return NULL;
+         }
+         else if(*szPos == '*')
+         {
+            // Matches anything; any digits before it are ignored
+         }
+         else if(*szPos == '-' && rangeStart < 0)
+         {
+            // The start of a range
+            if(modFlag)
+               return szPos;
+
+            if(!ParseNumber(szNum, szPos, rangeStart, minVal, maxVal))
+               return szNum;
+         }
+         else if(*szPos == '/' && !modFlag)
+         {
+            // The step follows; any digits before it are ignored
+            modFlag = true;
+         }
+         else
+         {
+            return szPos;
+         }
+
+         szNum = szPos + 1;
+      }
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: CronDrift::Set
+//
+//------------------------------------------------
+const bool CronDrift::Set(const int value)
+{
+   // Keep our list sorted and unique
+   unsigned index = 0;
+   while(index < m_count && m_value[index] < value)
+      index++;
+
+   if(index < m_count && m_value[index] == value)
+      return true;
+
+   if(m_count >= MAX_ENTRIES)
+      return false;
+
+   for(unsigned pos = m_count; pos > index; pos--)
+      m_value[pos] = m_value[pos - 1];
+
+   m_value[index] = value;
+   m_count++;
+   return true;
+}
+
+//------------------------------------------------
+//
+//  Function: Constructor (empty; not valid)
+//
+//------------------------------------------------
+CronSchedule::CronSchedule()
+   : m_valid(false), m_errorPos(string::npos)
+{
+}
+
+//------------------------------------------------
+//
+//  Function: Constructor (accepts a cron string)
+//
+//------------------------------------------------
+CronSchedule::CronSchedule(const string& sCronStr, bool isISC)
+   : m_valid(false), m_errorPos(string::npos)
+{
+   Compile(sCronStr, isISC);
+}
+
+//------------------------------------------------
+//
+//  Function: Constructor (accepts each cron field)
+//
+//------------------------------------------------
+CronSchedule::CronSchedule(const string& sSecOffset,
+                           const string& sMinOffset,
+                           const string& sHourOffset,
+                           const string& sDomOffset,
+                           const string& sMonthOffset,
+                           const string& sDowOffset,
+                           const string& sDriftOffset)
+   : m_valid(false), m_errorPos(string::npos)
+{
+   Compile(sSecOffset, sMinOffset, sHourOffset, sDomOffset,
+           sMonthOffset, sDowOffset, sDriftOffset);
+}
+
+//------------------------------------------------
+//
+//  Function: Deconstructor
+//
+//------------------------------------------------
+CronSchedule::~CronSchedule()
+{
+}
+
+//------------------------------------------------
+//
+//  Function: Compile
+//            (using whitespace as a delimiter)
+//
+//------------------------------------------------
+const bool CronSchedule::Compile(const string& strIn, bool isISC)
+{
+   return Compile(strIn.data(), strIn.size(), isISC);
+}
+
+//------------------------------------------------
+//
+//  Function: Compile
+//            (using whitespace as a delimiter)
+//
+//------------------------------------------------
+const bool CronSchedule::Compile(const char* szCronStr, const size_t len,
+                                 bool isISC)
+{
+   //         Dateblock Format
+   //
+   //     +------------------------------ second (0 - 59)
+   //     |  +--------------------------- min (0 - 59)
+   //     |  |  +----------------------- hour (0 - 23)
+   //     |  |  |  +----------------- day of month (1 - 31)
+   //     |  |  |  |  +----------- month (1 - 12)
+   //     |  |  |  |  |  +----- day of week (0 - 6) (Sunday=0)
+   //     |  |  |  |  |  |  +- drift time (defaults to zero)
+   //     |  |  |  |  |  |  |
+   //     -  -  -  -  -  -  -
+   //     *  *  *  *  *  *  *
+   //
+   //         ISC Format (no second or drift)
+   //
+   //     +----------------------------- min (0 - 59)
+   //     |  +----------------------- hour (0 - 23)
+   //     |  |  +----------------- day of month (1 - 31)
+   //     |  |  |  +----------- month (1 - 12)
+   //     |  |  |  |  +----- day of week (0 - 6) (Sunday=0)
+   //     |  |  |  |  |
+   //     -  -  -  -  -
+   //     *  *  *  *  *
+
+   // ISC only processes the first 5 fields, where as
+   // otherwise we process the first 7
+   const int token_max = isISC?Date::ISC_CRON_FIELD_COUNT:
+                               Date::DBL_CRON_FIELD_COUNT;
+
+   // Every field points back into szCronStr; the ones that are never
+   // found are left empty (which is the same as '*')
+   const char* szEnd = szCronStr + len;
+   const char* szBegin[CRON_FIELD_COUNT];
+   const char* szFinish[CRON_FIELD_COUNT];
+   for(int index = 0; index < CRON_FIELD_COUNT; index++)
+      szBegin[index] = szFinish[index] = szEnd;
+
+   // ISC has no 'seconds' field so its fields are stored from the minute
+   // onwards
+   int field = isISC ? 1 : 0;
+   int count = 0;
+
+   for(const char* szPos = szCronStr; szPos < szEnd; )
+   {
+      if(IsSpace(*szPos))
+      {
+         szPos++;
+         continue;
+      }
+
+      const char* szToken = szPos;
+      while(szPos < szEnd && !IsSpace(*szPos))
+         szPos++;
+
+      if(count >= token_max)
+      {
+         // More entries then expected found
+         *this = CronSchedule();
+         m_errorPos = szToken - szCronStr;
+         return false;
+      }
+
+      // Look for a + as that signifies the drift entry
+      // The idea here is we want to be able to put +digit
+      // anywhere in our cron to just imediately interpret
+      // that value as a drift.  The fields in between are
+      // left as they are and no others may follow it.
+      if(isISC == false && *szToken == '+')
+      {
+         szBegin[CRON_FIELD_COUNT - 1] = szToken + 1;
+         szFinish[CRON_FIELD_COUNT - 1] = szPos;
+         count = token_max + 1;
+         continue;
+      }
+
+      szBegin[field] = szToken;
+      szFinish[field] = szPos;
+      field++;
+      count++;
+   }
+
+   #ifdef DEBUG
+   cerr << "DEBUG CronSchedule::Compile(";
+   for (int i = 0; i < CRON_FIELD_COUNT; i++)
+   {
+      cerr << (i?",":"");
+      cerr.write(szBegin[i], szFinish[i] - szBegin[i]);
+   }
+   cerr << ")," << " ISC=" << ((string) (isISC?"y":"n")) << endl;
+   #endif
+
+   const char* szError;
+   if(!CompileFields(szBegin, szFinish, szError) && szError)
+      m_errorPos = szError - szCronStr;
+   return m_valid;
+}
+
+//------------------------------------------------
+//
+//  Function: Compile
+//
+//------------------------------------------------
+const bool CronSchedule::Compile(const string& sSecOffset,
+                                 const string& sMinOffset,
+                                 const string& sHourOffset,
+                                 const string& sDomOffset,
+                                 const string& sMonthOffset,
+                                 const string& sDowOffset,
+                                 const string& sDriftOffset)
+{
+   const string* fields[CRON_FIELD_COUNT] = {
+      &sSecOffset, &sMinOffset, &sHourOffset, &sDomOffset,
+      &sMonthOffset, &sDowOffset, &sDriftOffset };
+
+   const char* szBegin[CRON_FIELD_COUNT];
+   const char* szFinish[CRON_FIELD_COUNT];
+   for(int index = 0; index < CRON_FIELD_COUNT; index++)
+   {
+      szBegin[index] = fields[index]->data();
+      szFinish[index] = szBegin[index] + fields[index]->size();
+   }
+
+   const char* szError;
+   if(CompileFields(szBegin, szFinish, szError) || !szError)
+      return m_valid;
+
+   // Report the position within the field that failed
+   for(int index = 0; index < CRON_FIELD_COUNT; index++)
+   {
+      if(szError >= szBegin[index] && szError <= szFinish[index])
+      {
+         m_errorPos = szError - szBegin[index];
+         break;
+      }
+   }
+   return false;
+}
+
+//------------------------------------------------
+//
+//  Function: CompileFields
+//
+//------------------------------------------------
+const bool CronSchedule::CompileFields(const char* const szBegin[],
+                                       const char* const szEnd[],
+                                       const char* &szError)
+{
+   // Start with a clean slate
+   *this = CronSchedule();
+
+   if((szError = ParseField(szBegin[0], szEnd[0], m_sec,
+                            Date::T_SEC_MIN, Date::T_SEC_MAX)) ||
+      (szError = ParseField(szBegin[1], szEnd[1], m_min,
+                            Date::T_MIN_MIN, Date::T_MIN_MAX)) ||
+      (szError = ParseField(szBegin[2], szEnd[2], m_hour,
+                            Date::T_HOUR_MIN, Date::T_HOUR_MAX)) ||
+      (szError = ParseField(szBegin[3], szEnd[3], m_dom,
+                            Date::T_DOM_MIN, Date::T_DOM_MAX)) ||
+      (szError = ParseField(szBegin[4], szEnd[4], m_month,
+                            Date::T_MONTH_MIN, Date::T_MONTH_MAX)) ||
+      (szError = ParseField(szBegin[5], szEnd[5], m_dow,
+                            Date::T_DOW_MIN, Date::T_DOW_MAX)) ||
+      (szError = ParseField(szBegin[6], szEnd[6], m_drift,
+                            Date::T_DRIFT_MIN, Date::T_DRIFT_MAX)))
+   {
+      // Parse Failure
+      return false;
+   }
+   return Finish();
+}
+
+//------------------------------------------------
+//
+//  Function: Compile
+//  (accepts a single value per field; values that
+//   are out of range leave the field unset)
+//
+//------------------------------------------------
+const bool CronSchedule::Compile(const int lSecOffset,
+                                 const int lMinOffset,
+                                 const int lHourOffset,
+                                 const int lDomOffset,
+                                 const int lMonthOffset,
+                                 const int lDowOffset,
+                                 const int lDriftOffset)
+{
+   // Start with a clean slate
+   *this = CronSchedule();
+
+   if(lSecOffset >= Date::T_SEC_MIN && lSecOffset <= Date::T_SEC_MAX)
+      m_sec.Set(lSecOffset);
+   if(lMinOffset >= Date::T_MIN_MIN && lMinOffset <= Date::T_MIN_MAX)
+      m_min.Set(lMinOffset);
+   if(lHourOffset >= Date::T_HOUR_MIN && lHourOffset <= Date::T_HOUR_MAX)
+      m_hour.Set(lHourOffset);
+   if(lDomOffset >= Date::T_DOM_MIN && lDomOffset <= Date::T_DOM_MAX)
+      m_dom.Set(lDomOffset);
+   if(lMonthOffset >= Date::T_MONTH_MIN && lMonthOffset <= Date::T_MONTH_MAX)
+      m_month.Set(lMonthOffset);
+   if(lDowOffset >= Date::T_DOW_MIN && lDowOffset <= Date::T_DOW_MAX)
+      m_dow.Set(lDowOffset);
+   if(lDriftOffset > Date::T_DRIFT_MIN && lDriftOffset <= Date::T_DRIFT_MAX)
+      m_drift.Set(lDriftOffset);
+
+   return Finish();
+}
+
+//------------------------------------------------
+//
+//  Function: Finish
+//
+//------------------------------------------------
+const bool CronSchedule::Finish()
+{
+   // At the very least the second must be set; if nothing else was then
+   // we default to the start of every minute
+   if(m_min.Empty() && m_hour.Empty() && m_dom.Empty() &&
+      m_month.Empty() && m_dow.Empty() && m_sec.Empty())
+      m_sec.Set(Date::T_SEC_MIN);
+
+   // Reset the items below the largest field that was specified
+   if(!(m_month.Empty() && m_dom.Empty() && m_dow.Empty()))
+   {
+      if(m_hour.Empty()) m_hour.Set(Date::T_HOUR_MIN);
+      if(m_min.Empty()) m_min.Set(Date::T_MIN_MIN);
+      if(m_sec.Empty()) m_sec.Set(Date::T_SEC_MIN);
+   }
+   else if(!m_hour.Empty())
+   {
+      if(m_min.Empty()) m_min.Set(Date::T_MIN_MIN);
+      if(m_sec.Empty()) m_sec.Set(Date::T_SEC_MIN);
+   }
+   else if(!m_min.Empty())
+   {
+      if(m_sec.Empty()) m_sec.Set(Date::T_SEC_MIN);
+   }
+
+   // Anything left unset will match everything in its range
+   if(m_min.Empty()) m_min.Fill(Date::T_MIN_MIN, Date::T_MIN_MAX);
+   if(m_hour.Empty()) m_hour.Fill(Date::T_HOUR_MIN, Date::T_HOUR_MAX);
+   if(m_dom.Empty()) m_dom.Fill(Date::T_DOM_MIN, Date::T_DOM_MAX);
+   if(m_month.Empty()) m_month.Fill(Date::T_MONTH_MIN, Date::T_MONTH_MAX);
+   if(m_dow.Empty()) m_dow.Fill(Date::T_DOW_MIN, Date::T_DOW_MAX);
+
+   // Make sure at least one of the days of the month exist in at least one
+   // of the months specified (the 31st of February can never happen)
+   for(int month = m_month.Next(Date::T_MONTH_MIN); month > 0;
+       month = m_month.Next(month + 1))
+   {
+      int dom = m_dom.Next(Date::T_DOM_MIN);
+      if(dom > 0 && dom <= MaxDOMs[month - 1])
+      {
+         m_valid = true;
+         break;
+      }
+   }
+   return m_valid;
+}
+
+//------------------------------------------------
+//
+//  Function: Next
+//
+//------------------------------------------------
+const bool CronSchedule::Next(const time_t tRef, time_t &tNext,
+                              const TimeZone& tz) const
+{
+   Segment segments[CronDrift::MAX_ENTRIES];
+   for(unsigned index = 0; index < CronDrift::MAX_ENTRIES; index++)
+      segments[index].tFrom = segments[index].tTo = 0;
+
+   // A single search only needs the offset to hold up until its match
+   return NextSegment(tRef, tNext, tz, segments, 0);
+}
+
+//------------------------------------------------
+//
+//  Function: Series
+//
+//------------------------------------------------
+const size_t CronSchedule::Series(const time_t tRef, time_t *tOut,
+                                  const size_t count,
+                                  const TimeZone& tz) const
+{
+   return Between(tRef, numeric_limits<time_t>::max(), tOut, count, tz);
+}
+
+//------------------------------------------------
+//
+//  Function: Between
+//
+//------------------------------------------------
+const size_t CronSchedule::Between(const time_t tStart, const time_t tEnd,
+                                   time_t *tOut, const size_t maxCount,
+                                   const TimeZone& tz) const
+{
+   if(!m_valid)
+      return 0;
+
+   Segment segments[CronDrift::MAX_ENTRIES];
+   for(unsigned index = 0; index < CronDrift::MAX_ENTRIES; index++)
+      segments[index].tFrom = segments[index].tTo = 0;
+
+   // Each match is the reference for the next one; our segments carry
+   // what we know about the timezone from one match to the next
+   size_t count = 0;
+   time_t tRef = tStart;
+   while(count < maxCount &&
+         NextSegment(tRef, tOut[count], tz, segments, CRON_SEGMENT_SPAN) &&
+         tOut[count] <= tEnd)
+   {
+      tRef = tOut[count++];
+   }
+   return count;
+}
+
+//------------------------------------------------
+//
+//  Function: NextSegment
+//
+//------------------------------------------------
+const bool CronSchedule::NextSegment(const time_t tRef, time_t &tNext,
+                                     const TimeZone& tz, Segment *segments,
+                                     const time_t tSpan) const
+{
+   if(!m_valid)
+      return false;
+
+   // A Drift adds time to the final result; so we need to find a match
+   // that is the drift in the past (relative to the reference time). If
+   // more then one drift was specified, the earliest result wins.
+   bool found = false;
+   unsigned index = 0;
+   do
+   {
+      int drift = (index < m_drift.Count()) ? m_drift[index] : 0;
+      time_t tMatch;
+      // We never return the reference time itself; otherwise calling
+      // us consecutively within the same second would always return
+      // the same result.
+      if(NextMatch(tRef - drift + 1, tMatch, tz, segments[index], tSpan))
+      {
+         tMatch += drift;
+         if(!found || tMatch < tNext)
+         {
+            tNext = tMatch;
+            found = true;
+         }
+      }
+   } while(++index < m_drift.Count());
+
+   return found;
+}
+
+//------------------------------------------------
+//
+//  Function: Operator ==
+//
+//------------------------------------------------
+const bool CronSchedule::operator==(const CronSchedule& right) const
+{
+   if(m_valid != right.m_valid ||
+      m_sec.Mask() != right.m_sec.Mask() ||
+      m_min.Mask() != right.m_min.Mask() ||
+      m_hour.Mask() != right.m_hour.Mask() ||
+      m_dom.Mask() != right.m_dom.Mask() ||
+      m_month.Mask() != right.m_month.Mask() ||
+      m_dow.Mask() != right.m_dow.Mask() ||
+      m_drift.Count() != right.m_drift.Count())
+      return false;
+
+   for(unsigned index = 0; index < m_drift.Count(); index++)
+   {
+      if(m_drift[index] != right.m_drift[index])
+         return false;
+   }
+   return true;
+}
+
+//------------------------------------------------
+//
+//  Function: Hash
+//
+//------------------------------------------------
+const size_t CronSchedule::Hash() const
+{
+   // FNV-1a over each of our fields
+   uint64_t hash = 14695981039346656037ULL;
+   uint64_t values[7] = {
+      m_sec.Mask(), m_min.Mask(), m_hour.Mask(), m_dom.Mask(),
+      m_month.Mask(), m_dow.Mask(), m_valid };
+
+   for(unsigned index = 0; index < 7 + m_drift.Count(); index++)
+   {
+      uint64_t value = (index < 7) ? values[index] :
+                                     (uint64_t)m_drift[index - 7];
+      for(unsigned byte = 0; byte < sizeof(value); byte++)
+      {
+         hash ^= (value >> (byte * 8)) & 0xff;
+         hash *= 1099511628211ULL;
+      }
+   }
+   return (size_t)hash;
+}
+
+//------------------------------------------------
+//
+//  Function: NextMatch
+//
+//------------------------------------------------
+const bool CronSchedule::NextMatch(const time_t tFrom, time_t &tMatch,
+                                   const TimeZone& tz, Segment &segment,
+                                   const time_t tSpan) const
+{
+   time_t tVal = tFrom;
+
+   #ifdef CRON_ASSERT_LOOP_LIMIT
+      // Only allow looping for a specific time before failing
+      unsigned cron_limit = CRON_ASSERT_LOOP_LIMIT;
+   #endif
+
+   // We search in local time using the UTC offset in effect; if the offset
+   // changes (daylight savings) before our match then we pick up our search
+   // again from the moment it changed.
+   while(1)
+   {
+   #ifdef CRON_ASSERT_LOOP_LIMIT
+      AssertLoopLimit(cron_limit, tFrom);
+   #endif
+      if(tVal < segment.tFrom || tVal >= segment.tTo)
+      {
+         // We know nothing about this moment in time yet
+         segment.tFrom = tVal;
+         segment.tTo = tVal + 1;
+         segment.lOffset = tz.Offset(tVal);
+      }
+
+      int64_t lMatch;
+      if(!NextLocal((int64_t)tVal + segment.lOffset, lMatch))
+         return false;
+
+      time_t tCandidate = (time_t)(lMatch - segment.lOffset);
+      if(tCandidate >= segment.tTo)
+      {
+         // Make sure the offset holds up until our candidate
+         time_t tLimit = (tCandidate - tVal < tSpan) ?
+                         tVal + tSpan : tCandidate;
+         segment.tTo = tz.NextTransition(segment.tTo - 1, tLimit);
+      }
+
+      if(tCandidate < segment.tTo)
+      {
+         tMatch = tCandidate;
+         return true;
+      }
+      tVal = segment.tTo;
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: NextLocal
+//
+//------------------------------------------------
+const bool CronSchedule::NextLocal(const int64_t lFrom, int64_t &lMatch) const
+{
+   int64_t days = Calendar::FloorDiv(lFrom, Calendar::SECS_PER_DAY);
+   int secs = (int)(lFrom - days * Calendar::SECS_PER_DAY);
+
+   int year, month, dom;
+   Calendar::CivilFromDays(days, year, month, dom);
+   int hour = secs / 3600;
+   int min = (secs / 60) % 60;
+   int sec = secs % 60;
+
+   const int yearLimit = year + CRON_YEAR_SPAN;
+   int next;
+
+   // Each field that does not match moves to its next permitted value (and
+   // resets everything below it); if it has none left then we carry into
+   // the field above it and start over.
+   while(year <= yearLimit)
+   {
+      next = m_month.Next(month);
+      if(next < 0)
+      {
+         year++;
+         month = Date::T_MONTH_MIN;
+         dom = Date::T_DOM_MIN;
+         hour = min = sec = 0;
+         continue;
+      }
+      else if(next != month)
+      {
+         month = next;
+         dom = Date::T_DOM_MIN;
+         hour = min = sec = 0;
+      }
+
+      next = MonthDays(year, month).Next(dom);
+      if(next < 0)
+      {
+         if(++month > Date::T_MONTH_MAX)
+         {
+            year++;
+            month = Date::T_MONTH_MIN;
+         }
+         dom = Date::T_DOM_MIN;
+         hour = min = sec = 0;
+         continue;
+      }
+      else if(next != dom)
+      {
+         dom = next;
+         hour = min = sec = 0;
+      }
+
+      next = m_hour.Next(hour);
+      if(next < 0)
+      {
+         dom++;
+         hour = min = sec = 0;
+         continue;
+      }
+      else if(next != hour)
+      {
+         hour = next;
+         min = sec = 0;
+      }
+
+      next = m_min.Next(min);
+      if(next < 0)
+      {
+         hour++;
+         min = sec = 0;
+         continue;
+      }
+      else if(next != min)
+      {
+         min = next;
+         sec = 0;
+      }
+
+      next = m_sec.Next(sec);
+      if(next < 0)
+      {
+         min++;
+         sec = 0;
+         continue;
+      }
+
+      lMatch = Calendar::ToSeconds(year, month, dom, hour, min, next);
+      return true;
+   }
+   return false;
+}
+
+//------------------------------------------------
+//
+//  Function: MonthDays
+//  Returns the days of the month that satisfy both
+//  the day of month and the day of week
+//
+//------------------------------------------------
+const CronField<uint32_t> CronSchedule::MonthDays(const int year,
+                                                  const int month) const
+{
+   int maxDays = Calendar::DaysInMonth(year, month);
+   uint64_t dayMask = m_dom.Mask() & ((1ULL << (maxDays + 1)) - 2);
+
+   if(m_dow.Mask() != (uint8_t)((1 << (Date::T_DOW_MAX + 1)) - 1))
+   {
+      int firstDow = Calendar::WeekDay(
+            Calendar::DaysFromCivil(year, month, 1));
+      uint64_t dowDays = 0;
+      for(int dow = m_dow.Next(Date::T_DOW_MIN); dow >= 0;
+          dow = m_dow.Next(dow + 1))
+         dowDays |= WEEKLY_DAYS << (1 + (dow - firstDow + 7) % 7);
+      dayMask &= dowDays;
+   }
+   return CronField<uint32_t>((uint32_t)dayMask);
+}
+
+//------------------------------------------------
+//
+//  Function: Prev
+//
+//------------------------------------------------
+const bool CronSchedule::Prev(const time_t tRef, time_t &tPrev,
+                              const TimeZone& tz) const
+{
+   if(!m_valid)
+      return false;
+
+   // The mirror image of Next(); we look for a match that is the drift in
+   // the past (relative to a moment before the reference time) and the
+   // latest result wins.
+   bool found = false;
+   unsigned index = 0;
+   do
+   {
+      int drift = (index < m_drift.Count()) ? m_drift[index] : 0;
+      time_t tMatch;
+      if(PrevMatch(tRef - drift - 1, tMatch, tz))
+      {
+         tMatch += drift;
+         if(!found || tMatch > tPrev)
+         {
+            tPrev = tMatch;
+            found = true;
+         }
+      }
+   } while(++index < m_drift.Count());
+
+   return found;
+}
+
+//------------------------------------------------
+//
+//  Function: PrevMatch
+//
+//------------------------------------------------
+const bool CronSchedule::PrevMatch(const time_t tFrom, time_t &tMatch,
+                                   const TimeZone& tz) const
+{
+   time_t tVal = tFrom;
+
+   #ifdef CRON_ASSERT_LOOP_LIMIT
+      // Only allow looping for a specific time before failing
+      unsigned cron_limit = CRON_ASSERT_LOOP_LIMIT;
+   #endif
+
+   // We search backwards in local time using the UTC offset in effect; if
+   // that offset didn't hold all the way back to our match then we pick up
+   // our search again from the moment before it took effect.
+   while(1)
+   {
+   #ifdef CRON_ASSERT_LOOP_LIMIT
+      AssertLoopLimit(cron_limit, tFrom);
+   #endif
+      long lOffset = tz.Offset(tVal);
+      int64_t lMatch;
+      if(!PrevLocal((int64_t)tVal + lOffset, lMatch))
+         return false;
+
+      time_t tCandidate = (time_t)(lMatch - lOffset);
+      time_t tTransition = tz.PrevTransition(tVal, tCandidate);
+      if(tTransition <= tCandidate)
+      {
+         tMatch = tCandidate;
+         return true;
+      }
+      tVal = tTransition - 1;
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: PrevLocal
+//
+//------------------------------------------------
+const bool CronSchedule::PrevLocal(const int64_t lFrom, int64_t &lMatch) const
+{
+   int64_t days = Calendar::FloorDiv(lFrom, Calendar::SECS_PER_DAY);
+   int secs = (int)(lFrom - days * Calendar::SECS_PER_DAY);
+
+   int year, month, dom;
+   Calendar::CivilFromDays(days, year, month, dom);
+   int hour = secs / 3600;
+   int min = (secs / 60) % 60;
+   int sec = secs % 60;
+
+   const int yearLimit = year - CRON_YEAR_SPAN;
+   int prev;
+
+   // Each field that does not match moves to its previous permitted value
+   // (and sets everything below it to its largest value); if it has none
+   // left then we borrow from the field above it and start over.
+   while(year >= yearLimit)
+   {
+      prev = m_month.Prev(month);
+      if(prev < 0)
+      {
+         year--;
+         month = Date::T_MONTH_MAX;
+         dom = Date::T_DOM_MAX;
+         hour = Date::T_HOUR_MAX;
+         min = Date::T_MIN_MAX;
+         sec = Date::T_SEC_MAX;
+         continue;
+      }
+      else if(prev != month)
+      {
+         month = prev;
+         dom = Date::T_DOM_MAX;
+         hour = Date::T_HOUR_MAX;
+         min = Date::T_MIN_MAX;
+         sec = Date::T_SEC_MAX;
+      }
+
+      prev = MonthDays(year, month).Prev(dom);
+      if(prev < 0)
+      {
+         if(--month < Date::T_MONTH_MIN)
+         {
+            year--;
+            month = Date::T_MONTH_MAX;
+         }
+         dom = Date::T_DOM_MAX;
+         hour = Date::T_HOUR_MAX;
+         min = Date::T_MIN_MAX;
+         sec = Date::T_SEC_MAX;
+         continue;
+      }
+      else if(prev != dom)
+      {
+         dom = prev;
+         hour = Date::T_HOUR_MAX;
+         min = Date::T_MIN_MAX;
+         sec = Date::T_SEC_MAX;
+      }
+
+      prev = m_hour.Prev(hour);
+      if(prev < 0)
+      {
+         dom--;
+         hour = Date::T_HOUR_MAX;
+         min = Date::T_MIN_MAX;
+         sec = Date::T_SEC_MAX;
+         continue;
+      }
+      else if(prev != hour)
+      {
+         hour = prev;
+         min = Date::T_MIN_MAX;
+         sec = Date::T_SEC_MAX;
+      }
+
+      prev = m_min.Prev(min);
+      if(prev < 0)
+      {
+         hour--;
+         min = Date::T_MIN_MAX;
+         sec = Date::T_SEC_MAX;
+         continue;
+      }
+      else if(prev != min)
+      {
+         min = prev;
+         sec = Date::T_SEC_MAX;
+      }
+
+      prev = m_sec.Prev(sec);
+      if(prev < 0)
+      {
+         min--;
+         sec = Date::T_SEC_MAX;
+         continue;
+      }
+
+      lMatch = Calendar::ToSeconds(year, month, dom, hour, min, prev);
+      return true;
+   }
+   return false;
+}
+
+//------------------------------------------------
+//
+//  Function: Matches
+//
+//------------------------------------------------
+const bool CronSchedule::Matches(const time_t tVal, const TimeZone& tz) const
+{
+   if(!m_valid)
+      return false;
+
+   // The moment in time matches if it is the drift after one whose local
+   // time matches every field
+   unsigned index = 0;
+   do
+   {
+      int drift = (index < m_drift.Count()) ? m_drift[index] : 0;
+      struct tm tmObj;
+      if(tz.LocalTime(tVal - drift, tmObj) &&
+         m_sec.Has(tmObj.tm_sec) && m_min.Has(tmObj.tm_min) &&
+         m_hour.Has(tmObj.tm_hour) && m_dom.Has(tmObj.tm_mday) &&
+         m_month.Has(tmObj.tm_mon + 1) && m_dow.Has(tmObj.tm_wday))
+         return true;
+   } while(++index < m_drift.Count());
+
+   return false;
+}
+
+//------------------------------------------------
+//
+//  Function: MatchMask
+//
+//------------------------------------------------
+const size_t CronSchedule::MatchMask(const time_t *tIn, const size_t count,
+                                     uint64_t *mask,
+                                     const TimeZone& tz) const
+{
+   memset(mask, 0, ((count + 63) / 64) * sizeof(uint64_t));
+   if(!m_valid)
+      return 0;
+
+   const MatchMasks masks = {
+      (uint32_t)m_sec.Mask(), (uint32_t)(m_sec.Mask() >> 32),
+      (uint32_t)m_min.Mask(), (uint32_t)(m_min.Mask() >> 32),
+      m_hour.Mask(), m_dom.Mask(), m_month.Mask(), m_dow.Mask() };
+
+   // Each block is broken down into local time (once per drift value) by
+   // DateBatch and then every field is tested at once
+   MatchBlock block;
+   time_t tDrift[MATCH_BLOCK];
+   const DateFields fields = { NULL, block.month, block.dom, block.hour,
+                               block.min, block.sec, block.dow };
+   size_t matches = 0;
+
+   for(size_t offset = 0; offset < count; offset += MATCH_BLOCK)
+   {
+      const time_t *tBlock = tIn + offset;
+      const size_t size = (count - offset < MATCH_BLOCK) ?
+                          count - offset : MATCH_BLOCK;
+
+      memset(block.hit, 0, size * sizeof(uint32_t));
+      unsigned index = 0;
+      do
+      {
+         int drift = (index < m_drift.Count()) ? m_drift[index] : 0;
+         if(drift == 0)
+            DateBatch::ToFields(tBlock, size, fields, tz);
+         else
+         {
+            for(size_t entry = 0; entry < size; entry++)
+               tDrift[entry] = tBlock[entry] - drift;
+            DateBatch::ToFields(tDrift, size, fields, tz);
+         }
+         MatchKernel(block, masks, size);
+      } while(++index < m_drift.Count());
+
+      uint64_t *maskBlock = mask + offset / 64;
+      for(size_t entry = 0; entry < size; entry++)
+      {
+         maskBlock[entry / 64] |= (uint64_t)block.hit[entry] << (entry % 64);
+         matches += block.hit[entry];
+      }
+   }
+   return matches;
+}
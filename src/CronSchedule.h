@@ -0,0 +1,380 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _CRON_SCHEDULE_H
+#define _CRON_SCHEDULE_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <stdint.h>
+#include <string>
+#include "TimeZone.h"
+
+using namespace std;
+
+// A cron field stored as a bitmask; bit 'n' is set if the value 'n' is
+// permitted.  The width of T must be large enough to hold the largest
+// value the field can take on.
+template <class T>
+class CronField
+{
+   public:
+     CronField() : m_mask(0) {}
+     explicit CronField(const T mask) : m_mask(mask) {}
+
+     // Permits a value; returns false if it is too large to be stored
+     const bool Set(const int value);
+
+     // Permits every value between minVal and maxVal (inclusive)
+     void Fill(const int minVal, const int maxVal);
+
+     // Returns true if the value is permitted
+     const bool Has(const int value) const;
+
+     // Returns the smallest permitted value that is greater then or
+     // equal to the one specified or -1 if there isn't one.
+     const int Next(const int value) const;
+
+     // Returns the largest permitted value that is less then or equal
+     // to the one specified or -1 if there isn't one.
+     const int Prev(const int value) const;
+
+     // Returns true if no values are permitted
+     const bool Empty() const;
+
+     const T Mask() const;
+
+   private:
+     T m_mask;
+};
+
+// The drift (in seconds) can be far larger then any bitmask could hold so
+// we keep a small sorted list of them instead.
+class CronDrift
+{
+   public:
+     // The maximum number of drift values a cron entry can specify
+     static const unsigned MAX_ENTRIES = 16;
+
+     CronDrift() : m_count(0) {}
+
+     // Adds a drift value; returns false if there is no room left
+     const bool Set(const int value);
+
+     const bool Empty() const;
+     const unsigned Count() const;
+     const int operator[](const unsigned index) const;
+
+   private:
+     int m_value[MAX_ENTRIES];
+     unsigned m_count;
+};
+
+// A CronSchedule is a cron entry that has been parsed exactly once into a
+// bitmask per field.  Finding the next moment in time that matches it is
+// then a single walk from the month down to the second where each field
+// jumps straight to its next permitted value and a field that runs out of
+// values simply carries into the one above it.
+//
+// The rules applied to fields that were not specified ('*') are identical
+// to those of Date::Cron():
+//   - If nothing other than the second (and drift) was specified, the
+//     second defaults to 0.
+//   - The second, minute and hour default to 0 when they sit below the
+//     largest field that was specified (hence '-o 3' means 03:00:00 and
+//     not every second of the third hour).
+//   - The day of month, day of week and month match anything.
+class CronSchedule
+{
+   public:
+     CronSchedule();
+     CronSchedule(const string& sCronStr, bool isISC);
+     CronSchedule(const string& sSecOffset,
+                  const string& sMinOffset,
+                  const string& sHourOffset,
+                  const string& sDomOffset   = "*",
+                  const string& sMonthOffset = "*",
+                  const string& sDowOffset   = "*",
+                  const string& sDriftOffset = "*");
+     ~CronSchedule();
+
+     // Parses a whitespace delimited cron string (see Date::Cron()); returns
+     // false if it could not be parsed (or can never match a moment in
+     // time).
+     const bool Compile(const string& sCronStr, bool isISC = false);
+
+     // The same as the above for the first len characters of szCronStr;
+     // nothing is copied (or allocated) while it is parsed.
+     const bool Compile(const char* szCronStr, const size_t len,
+                        bool isISC = false);
+
+     // Parses the cron fields specified; returns false if they
+     // could not be parsed (or can never match a moment in time).
+     const bool Compile(const string& sSecOffset,
+                        const string& sMinOffset,
+                        const string& sHourOffset,
+                        const string& sDomOffset   = "*",
+                        const string& sMonthOffset = "*",
+                        const string& sDowOffset   = "*",
+                        const string& sDriftOffset = "*");
+
+     // Compiles a single value per field (Date::T_NO_ENTRY or any other
+     // value that is out of range leaves the field unset); returns false
+     // if the schedule can never match a moment in time.
+     const bool Compile(const int lSecOffset,
+                        const int lMinOffset,
+                        const int lHourOffset,
+                        const int lDomOffset,
+                        const int lMonthOffset,
+                        const int lDowOffset,
+                        const int lDriftOffset);
+
+     // Returns true if the schedule was compiled successfully
+     const bool Valid() const;
+
+     // Returns the offset of the character the last Compile() could not
+     // parse (within the field that contained it if each field was passed
+     // in separately); string::npos is returned if there was no syntax
+     // error (the schedule may still never match a moment in time).
+     const size_t ErrorPos() const;
+
+     // Calculates the next moment in time (after tRef) that matches
+     // the schedule (drift included) in the timezone specified.  Returns
+     // false if the schedule is not valid.
+     const bool Next(const time_t tRef, time_t &tNext,
+                     const TimeZone& tz = TimeZone::Local()) const;
+
+     // Calculates the last moment in time (before tRef) that matched the
+     // schedule (drift included) in the timezone specified.  Returns false
+     // if the schedule is not valid.
+     const bool Prev(const time_t tRef, time_t &tPrev,
+                     const TimeZone& tz = TimeZone::Local()) const;
+
+     // Stores (up to) the next 'count' moments in time after tRef that
+     // match the schedule in tOut; returns how many were stored.
+     const size_t Series(const time_t tRef, time_t *tOut, const size_t count,
+                         const TimeZone& tz = TimeZone::Local()) const;
+
+     // Stores (up to maxCount) moments in time after tStart and no later
+     // then tEnd that match the schedule in tOut; returns how many were
+     // stored.
+     const size_t Between(const time_t tStart, const time_t tEnd,
+                          time_t *tOut, const size_t maxCount,
+                          const TimeZone& tz = TimeZone::Local()) const;
+
+     // Returns true if the moment in time specified matches the schedule
+     // (drift included) in the timezone specified; that is to say Next()
+     // would return it if asked for the match after the second before it.
+     const bool Matches(const time_t tVal,
+                        const TimeZone& tz = TimeZone::Local()) const;
+
+     // The same as the above for count moments in time at once; bit 'n % 64'
+     // of mask[n / 64] is set if tIn[n] matches and cleared otherwise.  The
+     // mask must have room for (count + 63) / 64 entries.  Returns the
+     // number of moments in time that matched.
+     const size_t MatchMask(const time_t *tIn, const size_t count,
+                            uint64_t *mask,
+                            const TimeZone& tz = TimeZone::Local()) const;
+
+     // Compiled schedules are plain values that can be compared and hashed
+     const bool operator==(const CronSchedule& right) const;
+     const bool operator!=(const CronSchedule& right) const;
+     const size_t Hash() const;
+
+   private:
+     CronField<uint64_t> m_sec;
+     CronField<uint64_t> m_min;
+     CronField<uint32_t> m_hour;
+     CronField<uint32_t> m_dom;
+     CronField<uint16_t> m_month;
+     CronField<uint8_t> m_dow;
+     CronDrift m_drift;
+
+     bool m_valid;
+     size_t m_errorPos;
+
+     // Parses the 7 fields (second through to drift) found between each
+     // szBegin/szEnd pair; on a syntax error szError points to the
+     // character that couldn't be parsed (otherwise it is set to NULL).
+     const bool CompileFields(const char* const szBegin[],
+                              const char* const szEnd[],
+                              const char* &szError);
+
+     // Applies the defaults to the fields left unset once they have all
+     // been parsed and determines if the schedule is valid
+     const bool Finish();
+
+     // A span of time [tFrom, tTo) over which the UTC offset (lOffset) is
+     // known not to change.  Keeping these between searches means a series
+     // of them doesn't go looking for the same transitions over and over.
+     struct Segment
+     {
+        time_t tFrom;
+        time_t tTo;
+        long lOffset;
+     };
+
+     // Next() using (and updating) a Segment per drift value; each segment
+     // is stretched at least tSpan seconds past its starting point.
+     const bool NextSegment(const time_t tRef, time_t &tNext,
+                            const TimeZone& tz, Segment *segments,
+                            const time_t tSpan) const;
+
+     // Returns the first moment in time (at or after tFrom) that matches
+     // the schedule (without drift)
+     const bool NextMatch(const time_t tFrom, time_t &tMatch,
+                          const TimeZone& tz, Segment &segment,
+                          const time_t tSpan) const;
+
+     // Returns the first local (wall clock) time (in seconds) at or after
+     // lFrom that matches the schedule
+     const bool NextLocal(const int64_t lFrom, int64_t &lMatch) const;
+
+     // Returns the last moment in time (at or before tFrom) that matches
+     // the schedule (without drift)
+     const bool PrevMatch(const time_t tFrom, time_t &tMatch,
+                          const TimeZone& tz) const;
+
+     // Returns the last local (wall clock) time (in seconds) at or before
+     // lFrom that matches the schedule
+     const bool PrevLocal(const int64_t lFrom, int64_t &lMatch) const;
+
+     // Returns the days of the month that match both the day of month and
+     // the day of week
+     const CronField<uint32_t> MonthDays(const int year,
+                                         const int month) const;
+};
+
+template <class T>
+inline const bool CronField<T>::Set(const int value)
+{
+   if(value < 0 || value >= (int)(sizeof(T) * 8))
+      return false;
+
+   m_mask |= (T)((T)1 << value);
+   return true;
+}
+
+template <class T>
+inline void CronField<T>::Fill(const int minVal, const int maxVal)
+{
+   for(int value = minVal; value <= maxVal; value++)
+      Set(value);
+}
+
+template <class T>
+inline const bool CronField<T>::Has(const int value) const
+{
+   return (value >= 0 && value < (int)(sizeof(T) * 8) &&
+           (m_mask >> value) & 1);
+}
+
+template <class T>
+inline const int CronField<T>::Next(const int value) const
+{
+   if(value < 0)
+      return Next(0);
+   if(value >= (int)(sizeof(T) * 8))
+      return -1;
+
+   unsigned long long bits = (unsigned long long)m_mask >> value;
+   if(!bits)
+      return -1;
+
+#ifdef __GNUC__
+   return value + __builtin_ctzll(bits);
+#else
+   int offset = value;
+   while(!(bits & 1))
+   {
+      bits >>= 1;
+      offset++;
+   }
+   return offset;
+#endif
+}
+
+template <class T>
+inline const int CronField<T>::Prev(const int value) const
+{
+   if(value < 0)
+      return -1;
+   if(value >= (int)(sizeof(T) * 8))
+      return Prev((int)(sizeof(T) * 8) - 1);
+
+   // Keep only the bits at or below value
+   unsigned long long bits = (unsigned long long)m_mask &
+                             ((2ULL << value) - 1);
+   if(!bits)
+      return -1;
+
+#ifdef __GNUC__
+   return 63 - __builtin_clzll(bits);
+#else
+   int offset = 0;
+   while(bits >>= 1)
+      offset++;
+   return offset;
+#endif
+}
+
+template <class T>
+inline const bool CronField<T>::Empty() const
+{
+   return m_mask == 0;
+}
+
+template <class T>
+inline const T CronField<T>::Mask() const
+{
+   return m_mask;
+}
+
+inline const bool CronDrift::Empty() const
+{
+   return m_count == 0;
+}
+
+inline const unsigned CronDrift::Count() const
+{
+   return m_count;
+}
+
+inline const int CronDrift::operator[](const unsigned index) const
+{
+   return m_value[index];
+}
+
+inline const bool CronSchedule::Valid() const
+{
+   return m_valid;
+}
+
+inline const size_t CronSchedule::ErrorPos() const
+{
+   return m_errorPos;
+}
+
+inline const bool CronSchedule::operator!=(const CronSchedule& right) const
+{
+   return !(*this == right);
+}
+#endif
@@ -0,0 +1,238 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <ctype.h>
+#include "Date.h"
+#include "CronTable.h"
+
+using namespace std;
+
+//------------------------------------------------
+//
+//  Function: Constructor
+//
+//------------------------------------------------
+CronTable::CronTable(const TimeZone& tz) : m_tz(&tz)
+{
+}
+
+//------------------------------------------------
+//
+//  Function: Deconstructor
+//
+//------------------------------------------------
+CronTable::~CronTable()
+{
+}
+
+//------------------------------------------------
+//
+//  Function: Add
+//
+//------------------------------------------------
+const bool CronTable::Add(const CronSchedule& cron, const string& sJob,
+                          const time_t tRef)
+{
+   time_t tDue;
+   if(!cron.Next(tRef, tDue, *m_tz))
+      return false;
+
+   Entry entry;
+   entry.cron = cron;
+   entry.sJob = sJob;
+   m_entries.push_back(entry);
+
+   m_heap.push_back(Due(tDue, m_entries.size() - 1));
+   push_heap(m_heap.begin(), m_heap.end(), greater<Due>());
+   return true;
+}
+
+//------------------------------------------------
+//
+//  Function: AddLine
+//
+//------------------------------------------------
+const bool CronTable::AddLine(const string& sLine, bool isISC,
+                              const time_t tRef)
+{
+   const size_t len = sLine.size();
+   size_t pos = 0;
+   while(pos < len && isspace((unsigned char)sLine[pos]))
+      pos++;
+
+   // Nothing but a comment (or whitespace)
+   if(pos == len || sLine[pos] == '#')
+      return true;
+
+   // The cron fields end where the last of them does
+   const int fields = isISC ? Date::ISC_CRON_FIELD_COUNT :
+                              Date::DBL_CRON_FIELD_COUNT;
+   const size_t start = pos;
+   for(int field = 0; field < fields; field++)
+   {
+      if(pos == len)
+         return false;
+
+      while(pos < len && !isspace((unsigned char)sLine[pos]))
+         pos++;
+      while(field + 1 < fields && pos < len &&
+            isspace((unsigned char)sLine[pos]))
+         pos++;
+   }
+   const string sCron = sLine.substr(start, pos - start);
+
+   // Whatever is left over (less the whitespace around it) is the job
+   while(pos < len && isspace((unsigned char)sLine[pos]))
+      pos++;
+   size_t end = len;
+   while(end > pos && isspace((unsigned char)sLine[end - 1]))
+      end--;
+
+   CronSchedule cron;
+   if(!cron.Compile(sCron, isISC))
+      return false;
+
+   if(!Add(cron, sLine.substr(pos, end - pos), tRef))
+      return false;
+
+   m_entries.back().sCron = sCron;
+   return true;
+}
+
+//------------------------------------------------
+//
+//  Function: NextDue
+//
+//------------------------------------------------
+const bool CronTable::NextDue(time_t &tDue) const
+{
+   if(m_heap.empty())
+      return false;
+
+   tDue = m_heap.front().first;
+   return true;
+}
+
+//------------------------------------------------
+//
+//  Function: NextDue
+//
+//------------------------------------------------
+const bool CronTable::NextDue(const size_t index, time_t &tDue) const
+{
+   for(size_t pos = 0; pos < m_heap.size(); pos++)
+   {
+      if(m_heap[pos].second == index)
+      {
+         tDue = m_heap[pos].first;
+         return true;
+      }
+   }
+   return false;
+}
+
+//------------------------------------------------
+//
+//  Function: Fire
+//
+//------------------------------------------------
+const bool CronTable::Fire(const time_t tNow, size_t &index, time_t &tDue)
+{
+   if(m_heap.empty() || m_heap.front().first > tNow)
+      return false;
+
+   pop_heap(m_heap.begin(), m_heap.end(), greater<Due>());
+   tDue = m_heap.back().first;
+   index = m_heap.back().second;
+
+   // Only the schedule that came due is recalculated; one that can't be
+   // (it ran off the end of time) simply isn't put back
+   time_t tNext;
+   if(m_entries[index].cron.Next(tNow, tNext, *m_tz))
+   {
+      m_heap.back().first = tNext;
+      push_heap(m_heap.begin(), m_heap.end(), greater<Due>());
+   }
+   else
+      m_heap.pop_back();
+
+   return true;
+}
+
+//------------------------------------------------
+//
+//  Function: Reschedule
+//
+//------------------------------------------------
+void CronTable::Reschedule(const time_t tRef)
+{
+   m_heap.clear();
+   for(size_t index = 0; index < m_entries.size(); index++)
+   {
+      time_t tDue;
+      if(m_entries[index].cron.Next(tRef, tDue, *m_tz))
+         m_heap.push_back(Due(tDue, index));
+   }
+   make_heap(m_heap.begin(), m_heap.end(), greater<Due>());
+}
+
+//------------------------------------------------
+//
+//  Function: Job
+//
+//------------------------------------------------
+const string& CronTable::Job(const size_t index) const
+{
+   return m_entries[index].sJob;
+}
+
+//------------------------------------------------
+//
+//  Function: Cron
+//
+//------------------------------------------------
+const string& CronTable::Cron(const size_t index) const
+{
+   return m_entries[index].sCron;
+}
+
+//------------------------------------------------
+//
+//  Function: Size
+//
+//------------------------------------------------
+const size_t CronTable::Size() const
+{
+   return m_entries.size();
+}
+
+//------------------------------------------------
+//
+//  Function: Empty
+//
+//------------------------------------------------
+const bool CronTable::Empty() const
+{
+   return m_entries.empty();
+}
@@ -0,0 +1,96 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _CRON_TABLE_H
+#define _CRON_TABLE_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <string>
+#include <vector>
+#include "CronSchedule.h"
+
+using namespace std;
+
+// A CronTable is a list of schedules, each paired with a job (a line of
+// text the caller decides what to do with).  The moment in time each one is
+// next due is kept in a min-heap so finding the earliest is immediate and
+// only the schedule that just came due ever has to be recalculated.
+class CronTable
+{
+   public:
+     explicit CronTable(const TimeZone& tz = TimeZone::Local());
+     ~CronTable();
+
+     // Adds a schedule and works out when it is first due (after tRef);
+     // returns false (and adds nothing) if the schedule is not valid.
+     const bool Add(const CronSchedule& cron, const string& sJob,
+                    const time_t tRef);
+
+     // Adds a crontab style line: the cron fields (all 7 of them, or 5 if
+     // isISC is set) followed by the job.  Blank lines and those starting
+     // with a '#' are skipped (and true is returned).  Returns false if the
+     // fields could not be parsed.
+     const bool AddLine(const string& sLine, bool isISC, const time_t tRef);
+
+     // Stores the moment in time the earliest schedule is due; returns
+     // false if the table is empty.
+     const bool NextDue(time_t &tDue) const;
+
+     // The same as the above for the schedule at the index specified (the
+     // order they were added in); this has to search the heap for it.
+     const bool NextDue(const size_t index, time_t &tDue) const;
+
+     // If a schedule is due at (or before) tNow then its index and the
+     // moment in time it was due are stored and it is moved on to the
+     // first match after tNow (runs that were missed are skipped over as
+     // cron does).  Returns false if nothing is due.
+     const bool Fire(const time_t tNow, size_t &index, time_t &tDue);
+
+     // Works out when every schedule is next due (after tRef) all over
+     // again; for when the wall clock has been set
+     void Reschedule(const time_t tRef);
+
+     // The job (and the cron fields it was added with) at the index
+     // returned by Fire()
+     const string& Job(const size_t index) const;
+     const string& Cron(const size_t index) const;
+
+     const size_t Size() const;
+     const bool Empty() const;
+
+   private:
+     struct Entry
+     {
+        CronSchedule cron;
+        string sCron;
+        string sJob;
+     };
+
+     // When each entry is next due paired with its index; entries due at
+     // the same moment come out in the order they were added
+     typedef pair<time_t, size_t> Due;
+
+     vector<Entry> m_entries;
+     vector<Due> m_heap;
+     const TimeZone* m_tz;
+};
+#endif
@@ -24,14 +24,34 @@
 #endif
 
 #include <time.h>
+#include <stdint.h>
 #include <string>
 #include <sstream>
-#include <set>
 #include <vector>
 #include <iostream> // temporary
+#include "TimeZone.h"
 
 using namespace std;
 
+class DateFormat;
+
+// A span of time to move a date by (see Date::Add()); any field may be
+// negative.  The years, months and days move the date along the calendar
+// (the wall clock time of day is kept) while the hours, minutes and
+// seconds are time that elapses.
+struct DateOffset
+{
+   DateOffset() : years(0), months(0), days(0),
+                  hours(0), minutes(0), seconds(0) {}
+
+   long years;
+   long months;
+   long days;
+   long hours;
+   long minutes;
+   long seconds;
+};
+
 class Date
 {
    public:
@@ -70,6 +90,12 @@ class Date
           int second = 0);
      Date(const time_t localTime);
      Date(const struct tm& tmPtr);
+
+     // The same as the above but in the timezone specified instead of the
+     // system's local time; the TimeZone must outlive the Date object (and
+     // any copies of it).
+     explicit Date(const TimeZone& tz);
+     Date(const time_t localTime, const TimeZone& tz);
      Date(const Date& dateObjIn);
      ~Date();
 
@@ -102,6 +128,18 @@ class Date
      const bool AddMonth(const int months = 1);
      const bool AddYear(const int years = 1);
 
+     // Applies the whole offset in one step (rather then calling each of the
+     // above in turn).  The years and months are added together first; if
+     // the day of the month is past the end of the month that lands in it
+     // is clamped to the last day of it (Jan 31st plus a month is Feb 28th
+     // or 29th and Feb 29th plus a year is Feb 28th).  The days are then
+     // added on the calendar; the time of day stays the same on the wall
+     // clock (a local time that doesn't exist resolves as SetLocal() does).
+     // Finally the hours, minutes and seconds are added as elapsed time.
+     // Returns false (and leaves the date alone) if the result can't be
+     // represented.
+     const bool Add(const DateOffset& offset);
+
      const bool SetSec(const int seconds = 0);
      const bool SetMin(const int minutes = 0);
      const bool SetHour(const int hours = 0);
@@ -112,9 +150,26 @@ class Date
      const time_t Time()const;
      const struct tm& Tm()const;
 
+     // Moves to another timezone; the moment in time stays the same
+     void SetTimeZone(const TimeZone& tz);
+     const TimeZone& Zone()const;
+
      // returns a string based on passed in format
      const string Str(const string& format="%Y-%m-%d %H:%M:%S") const;
 
+     // The same as the above using a format that has already been parsed;
+     // use this when formatting many dates the same way
+     const string Str(const DateFormat& format) const;
+
+     // Parse is the inverse of Str(); it sets the date (in its timezone)
+     // from text written in the format specified.  Returns false (and
+     // leaves the date alone) if the text doesn't match the format; see
+     // DateFormat::Parse() for the details.
+     const bool Parse(const string& format, const string& input);
+     const bool Parse(const DateFormat& format, const string& input);
+     const bool Parse(const DateFormat& format,
+                      const char *szInput, const size_t len);
+
      const int Sec() const; // returns 0-59
      const int Min() const; // returns 0-59
      const int Hour() const; // returns 0-23
@@ -216,36 +271,58 @@ class Date
      const Date Cron(const string& sCronStr="*  *  *  *  *  *  *",
                      bool isISC = false) const;
 
+     // CronPrev is the reverse of Cron(); it returns a Date Object of the
+     // last moment in time (before this one) that matched the cron entry.
+     // The arguments (and the way drift is applied) are identical to
+     // those of the matching Cron() function.
+     const Date CronPrev(int lSecOffset   = T_NO_ENTRY,
+                         int lMinOffset   = T_NO_ENTRY,
+                         int lHourOffset  = T_NO_ENTRY,
+                         int lDomOffset   = T_NO_ENTRY,
+                         int lMonthOffset = T_NO_ENTRY,
+                         int lDowOffset   = T_NO_ENTRY,
+                         int lDriftOffset = T_NO_ENTRY) const;
+
+     const Date CronPrev(const string& sSecOffset,
+                         const string& sMinOffset,
+                         const string& sHourOffset,
+                         const string& sDomOffset   = "*",
+                         const string& sMonthOffset = "*",
+                         const string& sDowOffset   = "*",
+                         const string& sDriftOffset = "*") const;
+
+     const Date CronPrev(const string& sCronStr="*  *  *  *  *  *  *",
+                         bool isISC = false) const;
+
+     // CronSeries calculates (up to) the next 'count' moments in time that
+     // match the cron string (same format as above) and stores them in
+     // tOut, which must have room for them.  The cron string is only
+     // parsed once and each match picks up where the last one left off.
+     // Returns the number of moments in time stored.
+     const size_t CronSeries(const string& sCronStr,
+                             time_t *tOut,
+                             const size_t count,
+                             bool isISC = false) const;
+
+     // CronBetween stores (up to maxCount) moments in time after dStart
+     // (and no later then dEnd) that match the cron string in tOut; the
+     // timezone of dStart is used.  Returns the number stored.
+     static const size_t CronBetween(const string& sCronStr,
+                                     const Date& dStart,
+                                     const Date& dEnd,
+                                     time_t *tOut,
+                                     const size_t maxCount,
+                                     bool isISC = false);
+
    private:
      struct tm m_tmObj;
      time_t m_time;
+     const TimeZone* m_tz;
 
-     // Used in conjunction of advanced
-     // cron calculations
-     enum CronComboOffset {
-         COMBO_SEC = 0,
-         COMBO_MIN,
-         COMBO_HOUR,
-         COMBO_DOM,
-         COMBO_MONTH,
-         COMBO_DOW,
-         COMBO_DRIFT,
-         COMBO_COUNT
-      };
-
-     // Internal Tool
-     bool FindAndReplace(string &sourceString, const string &findString,
-                const string &replaceString) const;
-     bool FindAndReplace(string &sourceString, const string &findString,
-                const int &replaceNum,
-                int width = 1 ,
-                char fill = '0') const;
-
-     size_t Tokenize(const string& strIn, char delimiter,
-                     vector<string> &tokensOut) const;
-
-     bool ParseCronString(const string& strIn, set<int> &comboListOut,
-                            int minVal, int maxVal) const;
+     // Moves to the wall clock time (seconds since 1970-01-01 00:00:00 in
+     // local time) specified; all of the field math is done before this so
+     // the timezone is only consulted once.
+     const bool SetLocal(const int64_t lLocal);
 };
 
 inline const time_t Date::Time() const
@@ -257,6 +334,11 @@ inline const struct tm& Date::Tm() const
 {
    return m_tmObj;
 }
+
+inline const TimeZone& Date::Zone() const
+{
+   return *m_tz;
+}
 inline const int Date::Sec() const
 {
    return m_tmObj.tm_sec;
@@ -0,0 +1,342 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <stdint.h>
+#include "DateBatch.h"
+#include "Calendar.h"
+
+using namespace std;
+
+namespace {
+   // The number of dates converted at a time
+   const size_t BATCH_SIZE = 256;
+
+   // How far ahead (in seconds) we look for a change in the UTC offset
+   // each time we have to ask the timezone for one
+   const time_t BATCH_SEGMENT_SPAN = 604800;
+
+   // How many UTC offsets we try before settling on a local time
+   const unsigned BATCH_OFFSET_TRIES = 4;
+
+   // 0000-03-01 (the day the calendar math counts from) in days and
+   // seconds since 1970-01-01
+   const int64_t ERA_EPOCH = 719468;
+   const int64_t ERA_EPOCH_SECS = ERA_EPOCH * 86400;
+
+   // The vectorized math is done in 32 bits; local times this many bits
+   // wide (in seconds since 0000-03-01; up until the year 17000 or so) and
+   // dates within the years below are all it handles.  Anything else is
+   // handed to Calendar instead.
+   const int BATCH_SECS_BITS = 39;
+   const int BATCH_YEAR_MIN = 1;
+   const int BATCH_YEAR_MAX = 1000000;
+
+   // A block of dates; keeping every array in one structure lets the
+   // compiler see that none of them overlap.  Everything in here is 32 bits
+   // wide so a vector holds twice as many of them and the loops never have
+   // to widen or narrow values between arrays.
+   struct Block
+   {
+      uint32_t scaled[BATCH_SIZE]; // seconds since 0000-03-01 / 2^7
+      uint32_t days[BATCH_SIZE];   // since 0000-03-01
+      uint32_t secs[BATCH_SIZE];   // since midnight (or the 7 bits of
+                                   // seconds 'scaled' dropped)
+      int32_t other[BATCH_SIZE];   // set if Calendar has to do the math
+      int year[BATCH_SIZE];
+      int month[BATCH_SIZE];
+      int dom[BATCH_SIZE];
+      int hour[BATCH_SIZE];
+      int min[BATCH_SIZE];
+      int sec[BATCH_SIZE];
+      int dow[BATCH_SIZE];
+   };
+
+   // A span of time [tFrom, tTo) over which the UTC offset (lOffset) is
+   // known not to change
+   struct Segment
+   {
+      time_t tFrom;
+      time_t tTo;
+      long lOffset;
+   };
+
+   // Returns the UTC offset in effect at tVal, only asking the timezone if
+   // it falls outside of the segment we already know about
+   inline long SegmentOffset(const TimeZone& tz, Segment &segment,
+                             const time_t tVal)
+   {
+      if(tVal < segment.tFrom || tVal >= segment.tTo)
+      {
+         // Looking for the next transition only pays off when the dates
+         // arrive more or less in order; if this one is nowhere near the
+         // last then the segment is just this one second
+         const bool isNear = tVal >= segment.tFrom - BATCH_SEGMENT_SPAN &&
+                             tVal < segment.tTo + BATCH_SEGMENT_SPAN;
+         segment.tFrom = tVal;
+         segment.lOffset = tz.Offset(tVal);
+         segment.tTo = isNear ?
+            tz.NextTransition(tVal, tVal + BATCH_SEGMENT_SPAN) : tVal + 1;
+      }
+      return segment.lOffset;
+   }
+
+   // Returns the moment in time for the local time specified using the
+   // offset of the segment if it holds
+   inline time_t SegmentTime(const TimeZone& tz, Segment &segment,
+                             const int64_t lLocal)
+   {
+      time_t tVal = (time_t)(lLocal - segment.lOffset);
+      if(tVal >= segment.tFrom && tVal < segment.tTo)
+         return tVal;
+
+      // Otherwise keep applying the offset in effect until it agrees with
+      // itself; if it flips back and forth between two of them instead then
+      // the local time was skipped over (clocks sprung forward) and we take
+      // the later of the two (as Date::SetLocal() does)
+      time_t tLast = tVal;
+      for(unsigned tries = 0; tries < BATCH_OFFSET_TRIES; tries++)
+      {
+         const time_t tNext =
+            (time_t)(lLocal - SegmentOffset(tz, segment, tVal));
+         if(tNext == tVal)
+            break;
+
+         if(tNext == tLast)
+         {
+            tVal = (tNext > tVal) ? tNext : tVal;
+            break;
+         }
+         tLast = tVal;
+         tVal = tNext;
+      }
+
+      SegmentOffset(tz, segment, tVal);
+      return tVal;
+   }
+
+   // Copies a block's worth of a field out to the array specified
+   // (starting at offset); NULL arrays are skipped
+   inline void CopyOut(int *out, const size_t offset, const int *in,
+                       const size_t count)
+   {
+      if(out)
+         memcpy(out + offset, in, count * sizeof(int));
+   }
+
+   // Copies a block's worth of a field in from the array specified
+   // (starting at offset); a NULL array is read as the value specified
+   inline void CopyIn(int *out, const int *in, const size_t offset,
+                      const size_t count, const int value)
+   {
+      if(in)
+         memcpy(out, in + offset, count * sizeof(int));
+      else
+      {
+         for(size_t index = 0; index < count; index++)
+            out[index] = value;
+      }
+   }
+
+   //------------------------------------------------
+   //
+   //  Function: CivilKernel
+   //  (scaled/secs to the date fields)
+   //
+   //------------------------------------------------
+   BATCH_KERNEL void CivilKernel(Block &block, const size_t count)
+   {
+      // The calendar math is that of Cassio Neri and Lorenz Schneider's
+      // "Euclidean affine functions and their application to calendar
+      // algorithms"; it is Calendar::CivilFromDays() with most of the
+      // divisions replaced by multiplications and shifts.
+      for(size_t index = 0; index < count; index++)
+      {
+         // 86400 is 675 * 2^7
+         const uint32_t scaled = block.scaled[index];
+         const uint32_t days = scaled / 675;
+         const uint32_t secs = ((scaled - days * 675) << 7) |
+                               block.secs[index];
+
+         const uint32_t n1 = 4 * days + 3;
+         const uint32_t century = n1 / 146097;
+         const uint32_t n2 = (n1 % 146097) | 3;
+         const uint64_t p2 = (uint64_t)2939745 * n2;
+         const uint32_t doy = (uint32_t)p2 / 11758980;
+         const uint32_t n3 = 2141 * doy + 197913;
+         const uint32_t jan = doy >= 306;
+
+         block.year[index] = (int)(100 * century + (uint32_t)(p2 >> 32) + jan);
+         block.month[index] = (int)((n3 >> 16) - 12 * jan);
+         block.dom[index] = (int)((((n3 & 0xffff) * 31345) >> 26) + 1);
+
+         // 0000-03-01 was a Wednesday
+         block.dow[index] = (int)((days + 3) % 7);
+
+         // secs / 60 is (secs / 4) / 15 to keep the product in 32 bits
+         const uint32_t mins = ((secs >> 2) * 17477) >> 18;
+         const uint32_t hours = (mins * 1093) >> 16;
+         block.hour[index] = (int)hours;
+         block.min[index] = (int)(mins - hours * 60);
+         block.sec[index] = (int)(secs - mins * 60);
+      }
+   }
+
+   //------------------------------------------------
+   //
+   //  Function: DaysKernel
+   //  (the date fields to days/secs)
+   //
+   //------------------------------------------------
+   BATCH_KERNEL void DaysKernel(Block &block, const size_t count)
+   {
+      for(size_t index = 0; index < count; index++)
+      {
+         const int year = block.year[index];
+         const int month = block.month[index];
+         const int dom = block.dom[index];
+         const int hour = block.hour[index];
+         const int min = block.min[index];
+         const int sec = block.sec[index];
+
+         // Anything out of the ordinary is left for Calendar::ToSeconds()
+         block.other[index] =
+            (year < BATCH_YEAR_MIN) | (year > BATCH_YEAR_MAX) |
+            (month < 1) | (month > 12) | (dom < 1) | (dom > 31) |
+            (hour < 0) | (hour > 23) | (min < 0) | (min > 59) |
+            (sec < 0) | (sec > 60);
+
+         // Calendar::DaysFromCivil() counting from 0000-03-01; the year is
+         // forced in range so the math stays well defined for the dates we
+         // throw away
+         const uint32_t jan = month <= 2;
+         const uint32_t y = (uint32_t)(block.other[index] ? 1 : year) - jan;
+         const uint32_t m = (uint32_t)month + 12 * jan;
+         const uint32_t century = y / 100;
+
+         block.days[index] = 1461 * y / 4 - century + century / 4 +
+                             (979 * m - 2919) / 32 + (uint32_t)dom - 1;
+         block.secs[index] = (uint32_t)hour * 3600 + (uint32_t)min * 60 +
+                             (uint32_t)sec;
+      }
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: ToFields
+//
+//------------------------------------------------
+void DateBatch::ToFields(const time_t *tIn, const size_t count,
+                         const DateFields& fields, const TimeZone& tz)
+{
+   Block block;
+   Segment segment = { 0, 0, 0 };
+
+   for(size_t offset = 0; offset < count; offset += BATCH_SIZE)
+   {
+      const time_t *tBlock = tIn + offset;
+      const size_t size = (count - offset < BATCH_SIZE) ?
+                          count - offset : BATCH_SIZE;
+
+      for(size_t index = 0; index < size; index++)
+      {
+         const int64_t lLocal = (int64_t)tBlock[index] +
+                                SegmentOffset(tz, segment, tBlock[index]);
+
+         // Seconds since 0000-03-01
+         const uint64_t secs = (uint64_t)(lLocal + ERA_EPOCH_SECS);
+         block.scaled[index] = (uint32_t)(secs >> 7);
+         block.secs[index] = (uint32_t)secs & 0x7f;
+         block.other[index] = (secs >> BATCH_SECS_BITS) != 0;
+      }
+
+      CivilKernel(block, size);
+
+      // Dates that don't fit in 32 bits are left to Calendar
+      for(size_t index = 0; index < size; index++)
+      {
+         if(!block.other[index])
+            continue;
+
+         struct tm tmObj;
+         Calendar::FromSeconds((int64_t)tBlock[index] +
+                               tz.Offset(tBlock[index]), tmObj);
+         block.year[index] = tmObj.tm_year + 1900;
+         block.month[index] = tmObj.tm_mon + 1;
+         block.dom[index] = tmObj.tm_mday;
+         block.hour[index] = tmObj.tm_hour;
+         block.min[index] = tmObj.tm_min;
+         block.sec[index] = tmObj.tm_sec;
+         block.dow[index] = tmObj.tm_wday;
+      }
+
+      CopyOut(fields.year, offset, block.year, size);
+      CopyOut(fields.month, offset, block.month, size);
+      CopyOut(fields.dom, offset, block.dom, size);
+      CopyOut(fields.hour, offset, block.hour, size);
+      CopyOut(fields.min, offset, block.min, size);
+      CopyOut(fields.sec, offset, block.sec, size);
+      CopyOut(fields.dow, offset, block.dow, size);
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: ToTimes
+//
+//------------------------------------------------
+void DateBatch::ToTimes(const DateFields& fields, const size_t count,
+                        time_t *tOut, const TimeZone& tz)
+{
+   Block block;
+   Segment segment = { 0, 0, 0 };
+
+   for(size_t offset = 0; offset < count; offset += BATCH_SIZE)
+   {
+      const size_t size = (count - offset < BATCH_SIZE) ?
+                          count - offset : BATCH_SIZE;
+
+      CopyIn(block.year, fields.year, offset, size, 1970);
+      CopyIn(block.month, fields.month, offset, size, 1);
+      CopyIn(block.dom, fields.dom, offset, size, 1);
+      CopyIn(block.hour, fields.hour, offset, size, 0);
+      CopyIn(block.min, fields.min, offset, size, 0);
+      CopyIn(block.sec, fields.sec, offset, size, 0);
+
+      DaysKernel(block, size);
+
+      for(size_t index = 0; index < size; index++)
+      {
+         int64_t lLocal;
+         if(block.other[index])
+            lLocal = Calendar::ToSeconds(
+               block.year[index], block.month[index], block.dom[index],
+               block.hour[index], block.min[index], block.sec[index]);
+         else
+            lLocal = ((int64_t)block.days[index] - ERA_EPOCH) * 86400 +
+                     block.secs[index];
+
+         tOut[offset + index] = SegmentTime(tz, segment, lLocal);
+      }
+   }
+}
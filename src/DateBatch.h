@@ -0,0 +1,86 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _DATE_BATCH_H
+#define _DATE_BATCH_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <stddef.h>
+#include "TimeZone.h"
+
+using namespace std;
+
+// Marks a function made up of plain loops over blocks of dates that the
+// compiler should vectorize.  GCC only does so at -O3 (or when asked to)
+// and, where the toolchain supports it, we have it build a copy of the
+// function per instruction set and pick the best the CPU offers at run
+// time.
+#if defined(__GNUC__) && !defined(__clang__)
+#  ifdef HAVE_TARGET_CLONES
+#    define BATCH_KERNEL __attribute__((optimize("tree-vectorize"), \
+                            target_clones("avx2", "sse4.2", "default")))
+#  else
+#    define BATCH_KERNEL __attribute__((optimize("tree-vectorize")))
+#  endif
+#else
+#  define BATCH_KERNEL
+#endif
+
+// Broken down dates stored as a struct of arrays; element 'n' of each array
+// belongs to the same date.  Any array may be left NULL if the field isn't
+// of interest.
+struct DateFields
+{
+   int *year;
+   int *month; // 1-12 Jan=1, Dec=12
+   int *dom;   // 1-31
+   int *hour;  // 0-23
+   int *min;   // 0-59
+   int *sec;   // 0-59
+   int *dow;   // 0-6 Sun=0, Sat=6
+};
+
+// DateBatch converts whole arrays of dates at once.  It produces the same
+// results as constructing a Date for each element but without the per date
+// overhead; the timezone is only consulted when the UTC offset changes and
+// the calendar math is done with plain loops the compiler can vectorize.
+class DateBatch
+{
+   public:
+     // Breaks count moments in time down into local time in the timezone
+     // specified; 'fields' must have room for count entries in each of the
+     // arrays that aren't NULL.
+     static void ToFields(const time_t *tIn, const size_t count,
+                          const DateFields& fields,
+                          const TimeZone& tz = TimeZone::Local());
+
+     // The inverse of the above; fields left NULL default to those of
+     // 1970-01-01 00:00:00 and the day of week is ignored.  As with
+     // Calendar::ToSeconds() a field outside of its normal range carries
+     // into the one above it.  A local time that was skipped over (clocks
+     // sprung forward) resolves to the later of its two possible offsets;
+     // one that occurs twice keeps the offset of the date before it.
+     static void ToTimes(const DateFields& fields, const size_t count,
+                         time_t *tOut,
+                         const TimeZone& tz = TimeZone::Local());
+};
+#endif
@@ -0,0 +1,746 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <string.h>
+#include <ctype.h>
+#include <sstream>
+#include <iomanip>
+#include "DateFormat.h"
+#include "Calendar.h"
+
+using namespace std;
+
+namespace {
+   // locale’s abbreviated weekday name
+   const char dayAbbreva[7][4] =
+       {"Sun","Mon","Tue","Wed","Thu","Fri","Sat"};
+   const int Sun2Mon[7] =
+      {7,1,2,3,4,5,6};
+   const char dayOfWeek[7][10] =
+      {"Sunday","Monday","Tuesday","Wednesday","Thursday","Friday","Saturday"};
+   const char monAbbrev[12][4] =
+      {"Jan","Feb","Mar","Apr","May","Jun","Jul","Aug","Sep","Oct","Nov","Dec"};
+   const char monOfYear[12][10] =
+      {"January","February","March","April","May","June","July","August","September","October","November","December"};
+
+   // Every number from 00 to 99; two characters each
+   const char DIGIT_PAIRS[201] =
+      "00010203040506070809101112131415161718192021222324"
+      "25262728293031323334353637383940414243444546474849"
+      "50515253545556575859606162636465666768697071727374"
+      "75767778798081828384858687888990919293949596979899";
+
+   // The fields a format can contain (everything else is literal text)
+   const char FORMAT_FIELDS[] = "aAbBCdHIjklmMpPSsuUwyY";
+
+   // The largest number of characters a single field can write
+   const size_t MAX_FIELD_LEN = 24;
+
+   // Returns true if ch is one of the FORMAT_FIELDS
+   inline bool IsField(const char ch)
+   {
+      return ch != '\0' && strchr(FORMAT_FIELDS, ch) != NULL;
+   }
+
+   bool FindAndReplace(string &sourceString, const string &findString,
+         const string &replaceString)
+   {
+      string::size_type findStringLoc;
+      bool foundAtLeastOne;
+
+      if (findString == "" || findString == replaceString)
+      {
+         return false;
+      }
+
+      foundAtLeastOne = false;
+      findStringLoc = 0;
+
+      while ((findStringLoc = sourceString.find(findString, findStringLoc)) != string::npos)
+      {
+         sourceString.replace(findStringLoc, findString.length(), replaceString);
+         findStringLoc += replaceString.length();
+
+         foundAtLeastOne = true;
+      }
+
+      return(foundAtLeastOne);
+   }
+
+   bool FindAndReplace(string &sourceString, const string &findString,
+         const int64_t replaceNum, int width = 1, char fill = '0')
+   {
+      stringstream out;
+      out << setw(width) << setfill(fill) << (long long)replaceNum;
+      return FindAndReplace(sourceString, findString, out.str());
+   }
+
+   // Writes value into szOut (padded on the left with fill until it is at
+   // least width characters long); returns the number of characters
+   // written.
+   size_t FormatNumber(char *szOut, const int64_t value, const int width,
+                       const char fill)
+   {
+      // Build the digits backwards from the end of a scratch buffer
+      char szTmp[MAX_FIELD_LEN];
+      char *szPos = szTmp + sizeof(szTmp);
+      uint64_t num = (value < 0) ? 0ULL - (uint64_t)value : (uint64_t)value;
+
+      while(num >= 100)
+      {
+         const unsigned int pair = (unsigned int)(num % 100) * 2;
+         num /= 100;
+         *--szPos = DIGIT_PAIRS[pair + 1];
+         *--szPos = DIGIT_PAIRS[pair];
+      }
+      if(num >= 10)
+      {
+         *--szPos = DIGIT_PAIRS[num * 2 + 1];
+         *--szPos = DIGIT_PAIRS[num * 2];
+      }
+      else
+      {
+         *--szPos = (char)('0' + num);
+      }
+      if(value < 0)
+         *--szPos = '-';
+
+      // The fill goes in front of the sign (the way iostreams pad)
+      size_t digits = (szTmp + sizeof(szTmp)) - szPos;
+      size_t pad = ((size_t)width > digits) ? width - digits : 0;
+      memset(szOut, fill, pad);
+      memcpy(szOut + pad, szPos, digits);
+      return pad + digits;
+   }
+
+   // Copies szText (of len characters) into szOut
+   inline size_t FormatText(char *szOut, const char *szText, const size_t len)
+   {
+      memcpy(szOut, szText, len);
+      return len;
+   }
+
+   // Parse() keeps the value of each field it reads in an array indexed by
+   // the field's letter
+   const int FIELD_SLOTS = 'z' - 'A' + 1;
+   inline int& Slot(int *values, const char field)
+   {
+      return values[field - 'A'];
+   }
+
+   // Describes a field that is a number; the most digits it can have and
+   // the range its value must fall in.  Returns false if the field is not
+   // a number.
+   bool NumberField(const char field, int &width, int &minVal, int &maxVal)
+   {
+      switch(field)
+      {
+         case 'C': width = 2; minVal = 0; maxVal = 99; return true;
+         case 'd': width = 2; minVal = 1; maxVal = 31; return true;
+         case 'H': width = 2; minVal = 0; maxVal = 23; return true;
+         case 'I': width = 2; minVal = 1; maxVal = 12; return true;
+         case 'j': width = 3; minVal = 1; maxVal = 366; return true;
+         case 'k': width = 2; minVal = 0; maxVal = 23; return true;
+         case 'l': width = 2; minVal = 1; maxVal = 12; return true;
+         case 'm': width = 2; minVal = 1; maxVal = 12; return true;
+         case 'M': width = 2; minVal = 0; maxVal = 59; return true;
+         case 'S': width = 2; minVal = 0; maxVal = 60; return true;
+         case 'u': width = 1; minVal = 1; maxVal = 7; return true;
+         case 'U': width = 2; minVal = 0; maxVal = 53; return true;
+         case 'w': width = 1; minVal = 0; maxVal = 6; return true;
+         case 'y': width = 2; minVal = 0; maxVal = 99; return true;
+         case 'Y': width = 4; minVal = 0; maxVal = 9999; return true;
+      }
+      return false;
+   }
+
+   // Compares the first len characters of two strings ignoring case
+   bool SameText(const char *szLeft, const char *szRight, const size_t len)
+   {
+      for(size_t pos = 0; pos < len; pos++)
+      {
+         if(tolower((unsigned char)szLeft[pos]) !=
+            tolower((unsigned char)szRight[pos]))
+            return false;
+      }
+      return true;
+   }
+
+   // Reads one of the names specified (full or abbreviated to 3 letters)
+   // from szIn; returns the number of characters used or 0 if none match
+   size_t ParseName(const char *szIn, const char *szEnd,
+                    const char names[][10], const int count, int &index)
+   {
+      const size_t avail = szEnd - szIn;
+      for(index = 0; index < count; index++)
+      {
+         const size_t len = strlen(names[index]);
+         if(len <= avail && SameText(szIn, names[index], len))
+            return len;
+      }
+      for(index = 0; index < count; index++)
+      {
+         if(3 <= avail && SameText(szIn, names[index], 3))
+            return 3;
+      }
+      return 0;
+   }
+
+   // Turns the fields Parse() read into either local time or (when %s was
+   // read) a moment in time; returns false if they don't make up a date.
+   bool ParsedTime(int *values, const bool hasEpoch, const int64_t epoch,
+                   int64_t &lOut, bool &isLocal)
+   {
+      if(hasEpoch)
+      {
+         lOut = epoch;
+         isLocal = false;
+         return true;
+      }
+
+      int64_t year = 1970;
+      if(Slot(values, 'Y') >= 0)
+         year = Slot(values, 'Y');
+      else if(Slot(values, 'C') >= 0)
+         year = Slot(values, 'C') * 100 +
+                ((Slot(values, 'y') >= 0) ? Slot(values, 'y') : 0);
+      else if(Slot(values, 'y') >= 0)
+         // POSIX; 69-99 are 1969-1999 and 00-68 are 2000-2068
+         year = Slot(values, 'y') + ((Slot(values, 'y') < 69) ? 2000 : 1900);
+
+      int month = 1;
+      int dom = 1;
+      if(Slot(values, 'm') >= 0 || Slot(values, 'd') >= 0)
+      {
+         if(Slot(values, 'm') >= 0)
+            month = Slot(values, 'm');
+         if(Slot(values, 'd') >= 0)
+            dom = Slot(values, 'd');
+         if(dom > Calendar::DaysInMonth(year, month))
+            return false;
+      }
+      else if(Slot(values, 'j') >= 0)
+      {
+         // The day of the year carries into the month
+         dom = Slot(values, 'j');
+         if(dom > 365 + Calendar::IsLeap(year))
+            return false;
+      }
+
+      int hour = 0;
+      if(Slot(values, 'H') >= 0)
+         hour = Slot(values, 'H');
+      else if(Slot(values, 'k') >= 0)
+         hour = Slot(values, 'k');
+      else if(Slot(values, 'I') >= 0 || Slot(values, 'l') >= 0)
+      {
+         hour = ((Slot(values, 'I') >= 0) ? Slot(values, 'I') :
+                                            Slot(values, 'l')) % 12;
+         if(Slot(values, 'p') > 0)
+            hour += 12;
+      }
+
+      lOut = Calendar::ToSeconds(year, month, dom, hour,
+                                 (Slot(values, 'M') >= 0) ?
+                                    Slot(values, 'M') : 0,
+                                 (Slot(values, 'S') >= 0) ?
+                                    Slot(values, 'S') : 0);
+      isLocal = true;
+      return true;
+   }
+
+   // The hour (0-23) on the 12 hour clock (1-12)
+   inline int Hour12(const int hour)
+   {
+      return (hour % 12) ? (hour % 12) : 12;
+   }
+
+   // Writes a single field of the date into szOut (which has room for
+   // MAX_FIELD_LEN characters); returns the number of characters written.
+   // szYear holds the year as text.
+   size_t FormatField(char *szOut, const char field,
+                      const struct tm& tmVal, const time_t tVal,
+                      const char *szYear, const size_t yearLen)
+   {
+      switch(field)
+      {
+         case 'a':
+            return FormatText(szOut, dayAbbreva[tmVal.tm_wday], 3);
+         case 'A':
+            return FormatText(szOut, dayOfWeek[tmVal.tm_wday],
+                              strlen(dayOfWeek[tmVal.tm_wday]));
+         case 'b':
+            return FormatText(szOut, monAbbrev[tmVal.tm_mon], 3);
+         case 'B':
+            return FormatText(szOut, monOfYear[tmVal.tm_mon],
+                              strlen(monOfYear[tmVal.tm_mon]));
+         case 'C':
+            return FormatText(szOut, szYear, (yearLen < 2) ? yearLen : 2);
+         case 'd':
+            return FormatNumber(szOut, tmVal.tm_mday, 2, '0');
+         case 'H':
+            return FormatNumber(szOut, tmVal.tm_hour, 2, '0');
+         case 'I':
+            return FormatNumber(szOut, Hour12(tmVal.tm_hour), 2, '0');
+         case 'j':
+            return FormatNumber(szOut, tmVal.tm_yday + 1, 3, '0');
+         case 'k':
+            return FormatNumber(szOut, tmVal.tm_hour, 2, ' ');
+         case 'l':
+            return FormatNumber(szOut, Hour12(tmVal.tm_hour), 2, ' ');
+         case 'm':
+            return FormatNumber(szOut, tmVal.tm_mon + 1, 2, '0');
+         case 'M':
+            return FormatNumber(szOut, tmVal.tm_min, 2, '0');
+         case 'p':
+            return FormatText(szOut, (tmVal.tm_hour > 11) ? "PM" : "AM", 2);
+         case 'P':
+            return FormatText(szOut, (tmVal.tm_hour > 11) ? "pm" : "am", 2);
+         case 'S':
+            return FormatNumber(szOut, tmVal.tm_sec, 2, '0');
+         case 's':
+            return FormatNumber(szOut, (int64_t)tVal, 2, '0');
+         case 'u':
+            return FormatNumber(szOut, Sun2Mon[tmVal.tm_wday], 1, '0');
+         case 'U':
+            return FormatNumber(szOut, tmVal.tm_yday % 7, 2, '0');
+         case 'w':
+            return FormatNumber(szOut, tmVal.tm_wday, 1, '0');
+         case 'y':
+            if(yearLen <= 2)
+               return 0;
+            return FormatText(szOut, szYear + 2, (yearLen < 4) ? 1 : 2);
+         case 'Y':
+            return FormatNumber(szOut, tmVal.tm_year + 1900, 4, '0');
+      }
+      return 0;
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: Constructor
+//
+//------------------------------------------------
+DateFormat::DateFormat()
+   : m_sequential(false), m_fixedLen(0)
+{
+}
+
+//------------------------------------------------
+//
+//  Function: Constructor (accepts a format string)
+//
+//------------------------------------------------
+DateFormat::DateFormat(const string& sFormat)
+   : m_sequential(false), m_fixedLen(0)
+{
+   Compile(sFormat);
+}
+
+//------------------------------------------------
+//
+//  Function: Deconstructor
+//
+//------------------------------------------------
+DateFormat::~DateFormat()
+{
+}
+
+//------------------------------------------------
+//
+//  Function: Compile
+//
+//------------------------------------------------
+void DateFormat::Compile(const string& sFormat)
+{
+   m_pattern = sFormat;
+   m_expanded = sFormat;
+   m_literals.clear();
+   m_ops.clear();
+   m_sequential = false;
+   m_fixedLen = 0;
+   m_fixedLow.clear();
+   m_fixedSpan.clear();
+   m_fixedFields.clear();
+
+   // Syntax Swapping
+   // ---------------
+   // Support %c     locale’s date and time (e.g., Thu Mar  3 23:05:25 2005)
+   FindAndReplace(m_expanded,"%c","%a %b %d %H:%M:%S %Y");
+   // Support %D     date; same as %m/%d/%y
+   FindAndReplace(m_expanded,"%D","%m/%d/%y");
+   // Support %r     locale’s 12-hour clock time (e.g., 11:11:04 PM)
+   FindAndReplace(m_expanded,"%r","%H:%M:%S %p");
+   // Support %R     24-hour hour and minute; same as %H:%M
+   FindAndReplace(m_expanded,"%R","%H:%M");
+   // Support %T     time; same as %H:%M:%S
+   FindAndReplace(m_expanded,"%T","%H:%M:%S");
+   // Support %t     a tab
+   FindAndReplace(m_expanded,"%t","\t");
+   // Support %n     a new line
+   FindAndReplace(m_expanded,"%n","\n");
+   // Support %h     a new line
+   FindAndReplace(m_expanded,"%h","\n");
+   // Support %x     locale’s date representation (e.g., 12/31/99)
+   FindAndReplace(m_expanded,"%x","%M/%d/%y");
+   // Support %X     locale’s time representation (e.g., 23:13:48)
+   FindAndReplace(m_expanded,"%X","%H/%M/%S");
+
+   // Split what is left into literal text and fields
+   const size_t len = m_expanded.size();
+   size_t pos = 0;
+   while(pos < len)
+   {
+      if(m_expanded[pos] == '%' && pos + 1 < len &&
+         IsField(m_expanded[pos + 1]))
+      {
+         if(pos > 0 && m_expanded[pos - 1] == '%')
+            m_sequential = true;
+
+         FormatOp op = { m_expanded[pos + 1], 0, 0 };
+         m_ops.push_back(op);
+         pos += 2;
+         continue;
+      }
+
+      // Literal text runs up until the next field
+      size_t next = pos + 1;
+      while(next < len && !(m_expanded[next] == '%' && next + 1 < len &&
+                            IsField(m_expanded[next + 1])))
+         next++;
+
+      FormatOp op = { '\0', m_literals.size(), next - pos };
+      m_literals.append(m_expanded, pos, next - pos);
+      m_ops.push_back(op);
+      pos = next;
+   }
+
+   // Determine if every field is a fixed width number
+   vector<FormatOp>::const_iterator itr;
+   for(itr = m_ops.begin(); itr != m_ops.end(); itr++)
+   {
+      FixedField fixed = { itr->field, m_fixedLow.size(), 0, 0, 0 };
+      if(itr->field == '\0')
+      {
+         m_fixedLow.append(m_literals, itr->offset, itr->len);
+         m_fixedSpan.append(itr->len, '\0');
+      }
+      else if(itr->field != 'k' && itr->field != 'l' &&
+              NumberField(itr->field, fixed.width,
+                          fixed.minVal, fixed.maxVal))
+      {
+         m_fixedLow.append(fixed.width, '0');
+         m_fixedSpan.append(fixed.width, '\x09');
+         m_fixedFields.push_back(fixed);
+      }
+      else
+      {
+         m_fixedLow.clear();
+         m_fixedSpan.clear();
+         m_fixedFields.clear();
+         return;
+      }
+   }
+   m_fixedLen = m_fixedLow.size();
+}
+
+//------------------------------------------------
+//
+//  Function: Render
+//
+//------------------------------------------------
+const size_t DateFormat::Render(const struct tm& tmVal, const time_t tVal,
+                                char *szOut, const size_t len) const
+{
+   if(m_sequential)
+   {
+      const string sOut = Render(tmVal, tVal);
+      if(len > 0)
+      {
+         size_t copy = (sOut.size() < len) ? sOut.size() : len - 1;
+         memcpy(szOut, sOut.data(), copy);
+         szOut[copy] = '\0';
+      }
+      return sOut.size();
+   }
+
+   char szField[MAX_FIELD_LEN];
+   size_t total = 0;
+
+   // Build Year into String (to ease handling)
+   char szYear[MAX_FIELD_LEN];
+   const size_t yearLen = FormatNumber(szYear, tmVal.tm_year + 1900, 1, '0');
+
+   vector<FormatOp>::const_iterator itr;
+   for(itr = m_ops.begin(); itr != m_ops.end(); itr++)
+   {
+      const char *szText = szField;
+      size_t textLen;
+      if(itr->field == '\0')
+      {
+         szText = m_literals.data() + itr->offset;
+         textLen = itr->len;
+      }
+      else
+      {
+         textLen = FormatField(szField, itr->field, tmVal, tVal,
+                               szYear, yearLen);
+      }
+
+      // Copy whatever fits (leaving room for the NUL)
+      if(total + 1 < len)
+      {
+         size_t copy = (total + textLen < len) ? textLen : len - 1 - total;
+         memcpy(szOut + total, szText, copy);
+      }
+      total += textLen;
+   }
+
+   if(len > 0)
+      szOut[(total < len) ? total : len - 1] = '\0';
+   return total;
+}
+
+//------------------------------------------------
+//
+//  Function: Render
+//  (returns a string)
+//
+//------------------------------------------------
+const string DateFormat::Render(const struct tm& tmVal,
+                                const time_t tVal) const
+{
+   if(m_sequential)
+   {
+      string strFormat = m_expanded;
+
+      // Build Year into String (to ease handling)
+      string strYear;
+      stringstream ss;
+      ss << (tmVal.tm_year+1900);
+      strYear= ss.str();
+
+      // Date Swapping
+      // ---------------
+      // Support %a     locale’s abbreviated weekday name (e.g., Sun)
+      FindAndReplace(strFormat,"%a",dayAbbreva[tmVal.tm_wday]);
+      // Support %A     locale’s full weekday name (e.g., Sunday)
+      FindAndReplace(strFormat,"%A",dayOfWeek[tmVal.tm_wday]);
+      // Support %b     locale’s abbreviated month name (e.g., Jan)
+      FindAndReplace(strFormat,"%b",monAbbrev[tmVal.tm_mon]);
+      // Support %B     locale’s full month name (e.g., January)
+      FindAndReplace(strFormat,"%B",monOfYear[tmVal.tm_mon]);
+      // Support %C     century; like %Y, except omit last two digits (e.g., 21)
+      FindAndReplace(strFormat,"%C",strYear.substr(0,2));
+      // Support %d     day of month (e.g, 01)
+      FindAndReplace(strFormat,"%d",tmVal.tm_mday,2);
+      // Support %H     hour (00..23)
+      FindAndReplace(strFormat,"%H",tmVal.tm_hour,2);
+      // Support %I     hour (01..12)
+      FindAndReplace(strFormat,"%I",Hour12(tmVal.tm_hour),2);
+      // Support %j     day of year (001..366)
+      FindAndReplace(strFormat,"%j",tmVal.tm_yday + 1,3);
+      // Support %k     hour ( 0..23)
+      FindAndReplace(strFormat,"%k",tmVal.tm_hour,2,' ');
+      // Support %l     hour ( 1..12)
+      FindAndReplace(strFormat,"%l",Hour12(tmVal.tm_hour),2,' ');
+      // Support %m     month (00..59)
+      FindAndReplace(strFormat,"%m",(tmVal.tm_mon+1),2);
+      // Support %M     minute (00..59)
+      FindAndReplace(strFormat,"%M",(tmVal.tm_min),2);
+      // Support %p     locale’s equivalent of either AM or PM; blank if not known
+      FindAndReplace(strFormat,"%p",((tmVal.tm_hour>11)?"PM":"AM"));
+      // Support %P     like %p, but lower case
+      FindAndReplace(strFormat,"%P",((tmVal.tm_hour>11)?"pm":"am"));
+      // Support %S     second (00..60)
+      FindAndReplace(strFormat,"%S",(tmVal.tm_sec),2);
+      // Support %s     seconds since 1970-01-01 00:00:00 UTC
+      FindAndReplace(strFormat,"%s",(int64_t)tVal,2);
+      // Support %u     day of week (1..7); 1 is Monday
+      FindAndReplace(strFormat,"%u",Sun2Mon[tmVal.tm_wday],1);
+      // Support %U     week number of year, with Sunday as first day of week (00..53)
+      FindAndReplace(strFormat,"%U",tmVal.tm_yday%7,2);
+      // Support %w     day of week (0..6); 0 is Sunday;
+      FindAndReplace(strFormat,"%w",tmVal.tm_wday);
+      // Support %y     last two digits of year (00..99)
+      FindAndReplace(strFormat,"%y",
+            (strYear.size() > 2) ? strYear.substr(2,2) : string());
+      // Support %Y     year
+      FindAndReplace(strFormat,"%Y",(tmVal.tm_year)+1900,4);
+
+      return strFormat;
+   }
+
+   // Most dates fit on the stack; only go to the heap for the ones that
+   // don't
+   char szOut[256];
+   size_t len = Render(tmVal, tVal, szOut, sizeof(szOut));
+   if(len < sizeof(szOut))
+      return string(szOut, len);
+
+   vector<char> vOut(len + 1);
+   Render(tmVal, tVal, &vOut[0], vOut.size());
+   return string(&vOut[0], len);
+}
+
+//------------------------------------------------
+//
+//  Function: Parse
+//
+//------------------------------------------------
+const bool DateFormat::Parse(const char *szIn, const size_t len,
+                             int64_t &lOut, bool &isLocal) const
+{
+   int values[FIELD_SLOTS];
+   memset(values, 0xff, sizeof(values));
+
+   if(len == m_fixedLen && len > 0 && ParseFixed(szIn, values))
+      return ParsedTime(values, false, 0, lOut, isLocal);
+
+   memset(values, 0xff, sizeof(values));
+   const char *szPos = szIn;
+   const char *szEnd = szIn + len;
+   bool hasEpoch = false;
+   int64_t epoch = 0;
+
+   vector<FormatOp>::const_iterator itr;
+   for(itr = m_ops.begin(); itr != m_ops.end(); itr++)
+   {
+      const size_t avail = szEnd - szPos;
+      int width, minVal, maxVal, index;
+      size_t used;
+
+      if(itr->field == '\0')
+      {
+         if(itr->len > avail ||
+            memcmp(szPos, m_literals.data() + itr->offset, itr->len) != 0)
+            return false;
+         szPos += itr->len;
+      }
+      else if(NumberField(itr->field, width, minVal, maxVal))
+      {
+         // Space padded fields (and only those) may start with a space
+         if((itr->field == 'k' || itr->field == 'l') &&
+            szPos < szEnd && *szPos == ' ')
+         {
+            szPos++;
+            width--;
+         }
+
+         int value = 0;
+         const char *szStart = szPos;
+         while(szPos < szEnd && szPos - szStart < width &&
+               *szPos >= '0' && *szPos <= '9')
+            value = value * 10 + (*szPos++ - '0');
+
+         if(szPos == szStart || value < minVal || value > maxVal)
+            return false;
+         Slot(values, itr->field) = value;
+      }
+      else switch(itr->field)
+      {
+         case 'a':
+         case 'A':
+            if(!(used = ParseName(szPos, szEnd, dayOfWeek, 7, index)))
+               return false;
+            szPos += used;
+            break;
+         case 'b':
+         case 'B':
+            if(!(used = ParseName(szPos, szEnd, monOfYear, 12, index)))
+               return false;
+            Slot(values, 'm') = index + 1;
+            szPos += used;
+            break;
+         case 'p':
+         case 'P':
+            if(avail < 2 || tolower((unsigned char)szPos[1]) != 'm')
+               return false;
+            if(tolower((unsigned char)szPos[0]) == 'a')
+               Slot(values, 'p') = 0;
+            else if(tolower((unsigned char)szPos[0]) == 'p')
+               Slot(values, 'p') = 1;
+            else
+               return false;
+            szPos += 2;
+            break;
+         case 's':
+         {
+            // Seconds since the epoch (which may be negative)
+            const bool negative = (szPos < szEnd && *szPos == '-');
+            const char *szStart = negative ? ++szPos : szPos;
+            epoch = 0;
+            while(szPos < szEnd && szPos - szStart < 18 &&
+                  *szPos >= '0' && *szPos <= '9')
+               epoch = epoch * 10 + (*szPos++ - '0');
+            if(szPos == szStart)
+               return false;
+            if(negative)
+               epoch = -epoch;
+            hasEpoch = true;
+            break;
+         }
+         default:
+            return false;
+      }
+   }
+
+   if(szPos != szEnd)
+      return false;
+
+   return ParsedTime(values, hasEpoch, epoch, lOut, isLocal);
+}
+
+//------------------------------------------------
+//
+//  Function: ParseFixed
+//
+//------------------------------------------------
+const bool DateFormat::ParseFixed(const char *szIn, int *values) const
+{
+   // Every field sits at a known position so there is no need to look for
+   // where it ends; every character is checked in a single pass first
+   const unsigned char *szText = (const unsigned char *)szIn;
+   const unsigned char *szLow = (const unsigned char *)m_fixedLow.data();
+   const unsigned char *szSpan = (const unsigned char *)m_fixedSpan.data();
+   unsigned bad = 0;
+   for(size_t pos = 0; pos < m_fixedLen; pos++)
+      bad |= ((unsigned char)(szText[pos] - szLow[pos]) > szSpan[pos]);
+
+   if(bad)
+      return false;
+
+   vector<FixedField>::const_iterator itr;
+   for(itr = m_fixedFields.begin(); itr != m_fixedFields.end(); itr++)
+   {
+      const char *szPos = szIn + itr->pos;
+      int value = 0;
+      for(int digit = 0; digit < itr->width; digit++)
+         value = value * 10 + (szPos[digit] - '0');
+
+      bad |= (value < itr->minVal) | (value > itr->maxVal);
+      Slot(values, itr->field) = value;
+   }
+   return bad == 0;
+}
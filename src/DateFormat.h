@@ -0,0 +1,138 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _DATE_FORMAT_H
+#define _DATE_FORMAT_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A DateFormat is a format string (see Date::Str()) that has been parsed
+// exactly once into a list of operations; each one either copies some
+// literal text or writes out a single field of the date.  Rendering a date
+// is then a single pass over that list straight into the caller's buffer.
+//
+// The same list of operations can be walked the other way to read a date
+// back out of text (see Parse()).
+//
+// A DateFormat is never modified once it has been compiled so one instance
+// can be shared by as many threads as you like.
+class DateFormat
+{
+   public:
+     DateFormat();
+     explicit DateFormat(const string& sFormat);
+     ~DateFormat();
+
+     // Parses the format string specified
+     void Compile(const string& sFormat);
+
+     // Returns the format string this was compiled from
+     const string& Pattern() const;
+
+     // Writes the date (broken down into tmVal; tVal is only used by %s)
+     // into szOut which has room for len characters (the terminating NUL
+     // included).  Returns the length of the complete text; if this is len
+     // or more then it was truncated (just like snprintf()).
+     const size_t Render(const struct tm& tmVal, const time_t tVal,
+                         char *szOut, const size_t len) const;
+
+     // The same as the above but returns the text as a string
+     const string Render(const struct tm& tmVal, const time_t tVal) const;
+
+     // Reads a date written in this format from the first len characters
+     // of szIn (every one of them must be used); returns false if they
+     // don't match the format.
+     //
+     // Fields are read with their conventional meaning (%I is 01-12, %j is
+     // the day of the year, etc.), names and AM/PM in any case and numbers
+     // may be shorter then the width Render() pads them to.  Fields that
+     // only name or number the day of the week (%a %A %u %U %w) are checked
+     // but otherwise ignored.  A date without a year is in 1970, without a
+     // month or day it is the 1st of January and without a time it is
+     // midnight.
+     //
+     // lOut is set to the wall clock time (seconds since the epoch in local
+     // time) and isLocal to true unless the format holds %s; then lOut is
+     // the moment in time itself and isLocal is false.
+     const bool Parse(const char *szIn, const size_t len,
+                      int64_t &lOut, bool &isLocal) const;
+
+   private:
+     // A single step of the format; either the field it writes or (when
+     // field is zero) the literal text at offset in m_literals
+     struct FormatOp
+     {
+        char field;
+        size_t offset;
+        size_t len;
+     };
+
+     string m_pattern;
+
+     // The format with the composite specifiers (%c, %D, %T, etc) expanded
+     string m_expanded;
+     string m_literals;
+     vector<FormatOp> m_ops;
+
+     // Set when a literal '%' sits right in front of a field; the text of
+     // that field could form another specifier with it so these formats
+     // are rendered one specifier at a time (the way Date::Str() always
+     // did) to get exactly the same result.
+     bool m_sequential;
+
+     // A number at a fixed position of the text Parse() reads
+     struct FixedField
+     {
+        char field;
+        size_t pos;
+        int width;
+        int minVal;
+        int maxVal;
+     };
+
+     // When the format is nothing but literal text and fixed width numbers
+     // (such as ISO 8601; %Y-%m-%dT%H:%M:%S) every date it reads is this
+     // many characters long and is read without looking for where each
+     // field ends; 0 otherwise.
+     size_t m_fixedLen;
+
+     // The lowest character permitted at each position of a fixed width
+     // date and how far above it the character may be ('0' and 9 for a
+     // digit, the literal character and 0 for everything else)
+     string m_fixedLow;
+     string m_fixedSpan;
+     vector<FixedField> m_fixedFields;
+
+     // Parse() for fixed width formats
+     const bool ParseFixed(const char *szIn, int *values) const;
+};
+
+inline const string& DateFormat::Pattern() const
+{
+   return m_pattern;
+}
+#endif
@@ -0,0 +1,754 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "TimeZone.h"
+#include "Calendar.h"
+
+using namespace std;
+
+namespace {
+   const int64_t SECS_PER_WEEK = 604800;
+
+   // Where the zoneinfo database lives unless $TZDIR says otherwise
+   const char ZONEINFO_DIR[] = "/usr/share/zoneinfo";
+
+   // No TZif file worth reading is anywhere near this big
+   const size_t TZIF_MAX_SIZE = 1024 * 1024;
+
+   // The size of a TZif header
+   const size_t TZIF_HEADER_SIZE = 44;
+
+   // Reads a big endian signed integer 'size' bytes wide
+   int64_t ReadBE(const string& sData, const size_t pos, const size_t size)
+   {
+      uint64_t value = 0;
+      for(size_t index = 0; index < size; index++)
+         value = (value << 8) | (unsigned char)sData[pos + index];
+
+      // Sign extend 32 bit values
+      if(size == 4)
+         return (int64_t)(int32_t)(uint32_t)value;
+      return (int64_t)value;
+   }
+
+   // Parses a POSIX TZ zone abbreviation (EST or <-03>)
+   bool ParseAbbrev(const char* &szPos, string &sAbbrev)
+   {
+      const char *szStart = szPos;
+      if(*szPos == '<')
+      {
+         szStart = ++szPos;
+         while(*szPos && *szPos != '>')
+            szPos++;
+         if(*szPos != '>')
+            return false;
+         sAbbrev.assign(szStart, szPos - szStart);
+         szPos++;
+      }
+      else
+      {
+         while(isalpha(*szPos))
+            szPos++;
+         sAbbrev.assign(szStart, szPos - szStart);
+      }
+      return !sAbbrev.empty();
+   }
+
+   // Parses a POSIX TZ time ([+-]hh[:mm[:ss]]) into seconds
+   bool ParseTime(const char* &szPos, long &lTime)
+   {
+      long sign = 1;
+      if(*szPos == '+' || *szPos == '-')
+         sign = (*szPos++ == '-') ? -1 : 1;
+
+      long field[3] = {0, 0, 0};
+      for(int index = 0; index < 3; index++)
+      {
+         if(index && *szPos != ':')
+            break;
+         if(index)
+            szPos++;
+         if(!isdigit(*szPos))
+            return false;
+         while(isdigit(*szPos))
+         {
+            field[index] = field[index] * 10 + (*szPos++ - '0');
+            if(field[index] > 167)
+               return false;
+         }
+      }
+      lTime = sign * (field[0] * 3600 + field[1] * 60 + field[2]);
+      return true;
+   }
+
+   // Parses a number between minVal and maxVal
+   bool ParseNumber(const char* &szPos, int &value,
+                    const int minVal, const int maxVal)
+   {
+      if(!isdigit(*szPos))
+         return false;
+      value = 0;
+      while(isdigit(*szPos))
+      {
+         value = value * 10 + (*szPos++ - '0');
+         if(value > maxVal)
+            return false;
+      }
+      return value >= minVal;
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: Constructor (system local time)
+//
+//------------------------------------------------
+TimeZone::TimeZone()
+   : m_valid(true), m_system(true), m_hasRule(false), m_hasDst(false),
+     m_stdOffset(0), m_dstOffset(0)
+{
+}
+
+//------------------------------------------------
+//
+//  Function: Constructor (accepts a zone name)
+//
+//------------------------------------------------
+TimeZone::TimeZone(const string& sName)
+   : m_name(sName), m_valid(false), m_system(false), m_hasRule(false),
+     m_hasDst(false), m_stdOffset(0), m_dstOffset(0)
+{
+   // A leading colon is permitted (as it is in $TZ)
+   string sZone = (!sName.empty() && sName[0] == ':') ?
+                  sName.substr(1) : sName;
+   if(sZone.empty())
+      return;
+
+   if(sZone[0] == '/')
+   {
+      m_valid = LoadFile(sZone);
+      return;
+   }
+
+   // Never wander outside of the zoneinfo database
+   if(sZone.find("..") == string::npos)
+   {
+      const char *szDir = getenv("TZDIR");
+      m_valid = LoadFile(string((szDir && *szDir) ? szDir : ZONEINFO_DIR) +
+                         "/" + sZone);
+   }
+
+   if(!m_valid)
+   {
+      // It may be a POSIX TZ string instead of a zone name
+      m_valid = ParseRule(sZone);
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: Deconstructor
+//
+//------------------------------------------------
+TimeZone::~TimeZone()
+{
+}
+
+//------------------------------------------------
+//
+//  Function: Local
+//
+//------------------------------------------------
+const TimeZone& TimeZone::Local()
+{
+   static const TimeZone zone;
+   return zone;
+}
+
+//------------------------------------------------
+//
+//  Function: Utc
+//
+//------------------------------------------------
+const TimeZone& TimeZone::Utc()
+{
+   static const TimeZone zone("UTC0");
+   return zone;
+}
+
+//------------------------------------------------
+//
+//  Function: LoadFile
+//
+//------------------------------------------------
+const bool TimeZone::LoadFile(const string& sPath)
+{
+   ifstream file(sPath.c_str(), ios::in | ios::binary);
+   if(!file)
+      return false;
+
+   ostringstream data;
+   data << file.rdbuf();
+   if(data.str().size() > TZIF_MAX_SIZE)
+      return false;
+   return LoadTZif(data.str());
+}
+
+//------------------------------------------------
+//
+//  Function: LoadTZif
+//  Parses the contents of a TZif file (RFC 8536);
+//  leap seconds are not supported and ignored.
+//
+//------------------------------------------------
+const bool TimeZone::LoadTZif(const string& sData)
+{
+   if(sData.size() < TZIF_HEADER_SIZE || sData.compare(0, 4, "TZif") != 0)
+      return false;
+
+   const char version = sData[4];
+   size_t pos = 0;
+   size_t timeSize = 4;
+
+   while(1)
+   {
+      if(sData.size() < pos + TZIF_HEADER_SIZE)
+         return false;
+
+      const size_t isutCnt = (size_t)ReadBE(sData, pos + 20, 4);
+      const size_t isstdCnt = (size_t)ReadBE(sData, pos + 24, 4);
+      const size_t leapCnt = (size_t)ReadBE(sData, pos + 28, 4);
+      const size_t timeCnt = (size_t)ReadBE(sData, pos + 32, 4);
+      const size_t typeCnt = (size_t)ReadBE(sData, pos + 36, 4);
+      const size_t charCnt = (size_t)ReadBE(sData, pos + 40, 4);
+      pos += TZIF_HEADER_SIZE;
+
+      const size_t dataSize = timeCnt * timeSize + timeCnt + typeCnt * 6 +
+                              charCnt + leapCnt * (timeSize + 4) +
+                              isstdCnt + isutCnt;
+      if(typeCnt == 0 || typeCnt > 256 || charCnt == 0 ||
+         sData.size() < pos + dataSize)
+         return false;
+
+      // Version 2+ files repeat everything with 64 bit times; the first
+      // (32 bit) block is only there for older readers
+      if(version >= '2' && timeSize == 4)
+      {
+         pos += dataSize;
+         timeSize = 8;
+         continue;
+      }
+
+      // Everything is read into locals first so a file that turns out to
+      // be bad halfway through leaves the zone as it was
+      vector<int64_t> trans(timeCnt);
+      vector<unsigned char> transType(timeCnt);
+      vector<ZoneType> types(typeCnt);
+      for(size_t index = 0; index < timeCnt; index++)
+      {
+         trans[index] = ReadBE(sData, pos, timeSize);
+         if(index && trans[index] <= trans[index - 1])
+            return false;
+         pos += timeSize;
+      }
+      for(size_t index = 0; index < timeCnt; index++)
+      {
+         transType[index] = (unsigned char)sData[pos++];
+         if(transType[index] >= typeCnt)
+            return false;
+      }
+
+      for(size_t index = 0; index < typeCnt; index++)
+      {
+         types[index].offset = (long)ReadBE(sData, pos, 4);
+         types[index].isDst = sData[pos + 4] != 0;
+         types[index].abbrev = (unsigned char)sData[pos + 5];
+         if(types[index].abbrev >= charCnt)
+            return false;
+         pos += 6;
+      }
+
+      m_trans.swap(trans);
+      m_transType.swap(transType);
+      m_types.swap(types);
+
+      // Keep the abbreviations null terminated so we can point into them
+      m_abbrevs.assign(sData, pos, charCnt);
+      m_abbrevs += '\0';
+      pos += charCnt + leapCnt * (timeSize + 4) + isstdCnt + isutCnt;
+      break;
+   }
+
+   // The footer holds the POSIX TZ rule for times beyond the last transition
+   if(timeSize == 8 && pos < sData.size() && sData[pos] == '\n')
+   {
+      size_t end = sData.find('\n', pos + 1);
+      if(end != string::npos && end > pos + 1)
+      {
+         // A zone works without its rule (up to its last transition)
+         ParseRule(sData.substr(pos + 1, end - pos - 1));
+      }
+   }
+   return true;
+}
+
+//------------------------------------------------
+//
+//  Function: ParseRule
+//  Parses a POSIX TZ string such as:
+//     EST5EDT,M3.2.0,M11.1.0
+//
+//------------------------------------------------
+const bool TimeZone::ParseRule(const string& sRule)
+{
+   const char *szPos = sRule.c_str();
+   long lTime;
+
+   m_hasRule = m_hasDst = false;
+   if(!ParseAbbrev(szPos, m_stdAbbrev) || !ParseTime(szPos, lTime))
+      return false;
+
+   // POSIX offsets are west of UTC; ours are east
+   m_stdOffset = -lTime;
+   m_dstOffset = m_stdOffset;
+
+   if(*szPos)
+   {
+      if(!ParseAbbrev(szPos, m_dstAbbrev))
+         return false;
+
+      m_dstOffset = m_stdOffset + 3600;
+      if(*szPos && *szPos != ',')
+      {
+         if(!ParseTime(szPos, lTime))
+            return false;
+         m_dstOffset = -lTime;
+      }
+
+      // Without any rules we fall back to those used in the US
+      const char *szDefault = ",M3.2.0,M11.1.0";
+      if(!*szPos)
+         szPos = szDefault;
+
+      ZoneRule *rules[2] = {&m_dstStart, &m_dstEnd};
+      for(int index = 0; index < 2; index++)
+      {
+         ZoneRule &rule = *rules[index];
+         if(*szPos++ != ',')
+            return false;
+
+         rule.month = rule.week = rule.day = 0;
+         if(*szPos == 'J')
+         {
+            rule.kind = 'J';
+            if(!ParseNumber(++szPos, rule.day, 1, 365))
+               return false;
+         }
+         else if(*szPos == 'M')
+         {
+            rule.kind = 'M';
+            if(!ParseNumber(++szPos, rule.month, 1, 12) ||
+               *szPos++ != '.' ||
+               !ParseNumber(szPos, rule.week, 1, 5) ||
+               *szPos++ != '.' ||
+               !ParseNumber(szPos, rule.day, 0, 6))
+               return false;
+         }
+         else
+         {
+            rule.kind = 'D';
+            if(!ParseNumber(szPos, rule.day, 0, 365))
+               return false;
+         }
+
+         rule.time = 7200;
+         if(*szPos == '/' && !ParseTime(++szPos, rule.time))
+            return false;
+      }
+      m_hasDst = true;
+   }
+
+   if(*szPos)
+      return false;
+
+   m_hasRule = true;
+   return true;
+}
+
+//------------------------------------------------
+//
+//  Function: RuleYear
+//  Calculates when daylight savings starts and
+//  ends (in UTC) for the year specified
+//
+//------------------------------------------------
+void TimeZone::RuleYear(const int year, time_t &tStart, time_t &tEnd) const
+{
+   const ZoneRule *rules[2] = {&m_dstStart, &m_dstEnd};
+   int64_t tRule[2];
+
+   for(int index = 0; index < 2; index++)
+   {
+      const ZoneRule &rule = *rules[index];
+      int64_t days;
+      if(rule.kind == 'J')
+      {
+         // February 29th is never counted
+         days = Calendar::DaysFromCivil(year, 1, 1) + rule.day - 1 +
+                (rule.day >= 60 && Calendar::IsLeap(year));
+      }
+      else if(rule.kind == 'D')
+      {
+         days = Calendar::DaysFromCivil(year, 1, 1) + rule.day;
+      }
+      else
+      {
+         // The 'week'th 'day' of the month (5 meaning the last one)
+         int64_t first = Calendar::DaysFromCivil(year, rule.month, 1);
+         days = first + (rule.day - Calendar::WeekDay(first) + 7) % 7 +
+                (rule.week - 1) * 7;
+         while(days >= first + Calendar::DaysInMonth(year, rule.month))
+            days -= 7;
+      }
+
+      // The start is in standard time, the end in daylight savings time
+      tRule[index] = days * Calendar::SECS_PER_DAY + rule.time -
+                     (index ? m_dstOffset : m_stdOffset);
+   }
+   tStart = (time_t)tRule[0];
+   tEnd = (time_t)tRule[1];
+}
+
+//------------------------------------------------
+//
+//  Function: RuleIsDst
+//
+//------------------------------------------------
+const bool TimeZone::RuleIsDst(const time_t tVal) const
+{
+   if(!m_hasDst)
+      return false;
+
+   int year, month, dom;
+   Calendar::CivilFromDays(Calendar::FloorDiv((int64_t)tVal + m_stdOffset,
+                                              Calendar::SECS_PER_DAY),
+                           year, month, dom);
+
+   time_t tStart, tEnd;
+   RuleYear(year, tStart, tEnd);
+
+   // Daylight savings may wrap around the end of the year (southern
+   // hemisphere)
+   if(tStart < tEnd)
+      return tVal >= tStart && tVal < tEnd;
+   return !(tVal >= tEnd && tVal < tStart);
+}
+
+//------------------------------------------------
+//
+//  Function: RuleNext
+//  Finds the next rule based transition after
+//  tFrom; returns false if there isn't one.
+//
+//------------------------------------------------
+const bool TimeZone::RuleNext(const time_t tFrom, time_t &tNext) const
+{
+   if(!m_hasDst)
+      return false;
+
+   int year, month, dom;
+   Calendar::CivilFromDays(Calendar::FloorDiv((int64_t)tFrom + m_stdOffset,
+                                              Calendar::SECS_PER_DAY),
+                           year, month, dom);
+
+   bool found = false;
+   for(int y = year - 1; y <= year + 1; y++)
+   {
+      time_t tRule[2];
+      RuleYear(y, tRule[0], tRule[1]);
+      for(int index = 0; index < 2; index++)
+      {
+         if(tRule[index] > tFrom && (!found || tRule[index] < tNext))
+         {
+            tNext = tRule[index];
+            found = true;
+         }
+      }
+   }
+   return found;
+}
+
+//------------------------------------------------
+//
+//  Function: RulePrev
+//  Finds the last rule based transition at or
+//  before tFrom; returns false if there isn't one.
+//
+//------------------------------------------------
+const bool TimeZone::RulePrev(const time_t tFrom, time_t &tPrev) const
+{
+   if(!m_hasDst)
+      return false;
+
+   int year, month, dom;
+   Calendar::CivilFromDays(Calendar::FloorDiv((int64_t)tFrom + m_stdOffset,
+                                              Calendar::SECS_PER_DAY),
+                           year, month, dom);
+
+   bool found = false;
+   for(int y = year - 1; y <= year + 1; y++)
+   {
+      time_t tRule[2];
+      RuleYear(y, tRule[0], tRule[1]);
+      for(int index = 0; index < 2; index++)
+      {
+         if(tRule[index] <= tFrom && (!found || tRule[index] > tPrev))
+         {
+            tPrev = tRule[index];
+            found = true;
+         }
+      }
+   }
+   return found;
+}
+
+//------------------------------------------------
+//
+//  Function: Lookup
+//
+//------------------------------------------------
+void TimeZone::Lookup(const time_t tVal, long &lOffset, bool &isDst,
+                      const char* &szAbbrev) const
+{
+   if(m_hasRule && (m_trans.empty() || (int64_t)tVal >= m_trans.back()))
+   {
+      isDst = RuleIsDst(tVal);
+      lOffset = isDst ? m_dstOffset : m_stdOffset;
+      szAbbrev = isDst ? m_dstAbbrev.c_str() : m_stdAbbrev.c_str();
+      return;
+   }
+
+   // Times before the first transition use the first type
+   size_t type = 0;
+   if(!m_trans.empty() && (int64_t)tVal >= m_trans[0])
+   {
+      vector<int64_t>::const_iterator itr =
+         upper_bound(m_trans.begin(), m_trans.end(), (int64_t)tVal);
+      type = m_transType[(itr - m_trans.begin()) - 1];
+   }
+
+   lOffset = m_types[type].offset;
+   isDst = m_types[type].isDst;
+   szAbbrev = m_abbrevs.c_str() + m_types[type].abbrev;
+}
+
+//------------------------------------------------
+//
+//  Function: Offset
+//
+//------------------------------------------------
+const long TimeZone::Offset(const time_t tVal) const
+{
+   if(m_system)
+   {
+      struct tm tmObj;
+      if(!localtime_r(&tVal, &tmObj))
+         return 0;
+      return (long)(Calendar::ToSeconds(tmObj.tm_year + 1900,
+                                        tmObj.tm_mon + 1,
+                                        tmObj.tm_mday,
+                                        tmObj.tm_hour,
+                                        tmObj.tm_min,
+                                        tmObj.tm_sec) - tVal);
+   }
+
+   long lOffset = 0;
+   bool isDst;
+   const char *szAbbrev;
+   if(m_valid)
+      Lookup(tVal, lOffset, isDst, szAbbrev);
+   return lOffset;
+}
+
+//------------------------------------------------
+//
+//  Function: LocalTime
+//
+//------------------------------------------------
+const bool TimeZone::LocalTime(const time_t tVal, struct tm &tmOut) const
+{
+   if(m_system)
+      return localtime_r(&tVal, &tmOut) != NULL;
+
+   if(!m_valid)
+      return false;
+
+   long lOffset;
+   bool isDst;
+   const char *szAbbrev;
+   Lookup(tVal, lOffset, isDst, szAbbrev);
+
+   memset(&tmOut, 0, sizeof(struct tm));
+   Calendar::FromSeconds((int64_t)tVal + lOffset, tmOut);
+   tmOut.tm_isdst = isDst ? 1 : 0;
+#ifdef HAVE_STRUCT_TM_TM_GMTOFF
+   tmOut.tm_gmtoff = lOffset;
+#endif
+#ifdef HAVE_STRUCT_TM_TM_ZONE
+   tmOut.tm_zone = (char *)szAbbrev;
+#endif
+   return true;
+}
+
+//------------------------------------------------
+//
+//  Function: NextTransition
+//
+//------------------------------------------------
+const time_t TimeZone::NextTransition(const time_t tFrom,
+                                      const time_t tTo) const
+{
+   const long lOffset = Offset(tFrom);
+
+   if(m_system)
+   {
+      // We can't see the system's transitions so we probe a week at a time
+      // (no timezone changes its offset more often then that) and then
+      // narrow down on the exact second.
+      time_t tLo = tFrom;
+      while(tLo < tTo)
+      {
+         time_t tHi = (tTo - tLo > SECS_PER_WEEK) ? tLo + SECS_PER_WEEK : tTo;
+         if(Offset(tHi) != lOffset)
+         {
+            while(tHi - tLo > 1)
+            {
+               time_t tMid = tLo + (tHi - tLo) / 2;
+               if(Offset(tMid) == lOffset)
+                  tLo = tMid;
+               else
+                  tHi = tMid;
+            }
+            return tHi;
+         }
+         tLo = tHi;
+      }
+      return tTo + 1;
+   }
+
+   // Walk the transitions in our table; some of them only change the
+   // abbreviation so we keep going until the offset actually changes
+   vector<int64_t>::const_iterator itr =
+      upper_bound(m_trans.begin(), m_trans.end(), (int64_t)tFrom);
+   for( ; itr != m_trans.end() && *itr <= (int64_t)tTo; itr++)
+   {
+      if(Offset((time_t)*itr) != lOffset)
+         return (time_t)*itr;
+   }
+
+   // Then fall back to the rule beyond the end of them
+   if(m_hasRule && itr == m_trans.end())
+   {
+      time_t tVal = tFrom;
+      if(!m_trans.empty() && (int64_t)tVal < m_trans.back())
+         tVal = (time_t)m_trans.back();
+
+      time_t tNext;
+      while(RuleNext(tVal, tNext) && tNext <= tTo)
+      {
+         if(Offset(tNext) != lOffset)
+            return tNext;
+         tVal = tNext;
+      }
+   }
+   return tTo + 1;
+}
+
+//------------------------------------------------
+//
+//  Function: PrevTransition
+//
+//------------------------------------------------
+const time_t TimeZone::PrevTransition(const time_t tFrom,
+                                      const time_t tTo) const
+{
+   const long lOffset = Offset(tFrom);
+
+   if(m_system)
+   {
+      // The mirror image of what NextTransition() does
+      time_t tHi = tFrom;
+      while(tHi > tTo)
+      {
+         time_t tLo = (tHi - tTo > SECS_PER_WEEK) ? tHi - SECS_PER_WEEK : tTo;
+         if(Offset(tLo) != lOffset)
+         {
+            while(tHi - tLo > 1)
+            {
+               time_t tMid = tLo + (tHi - tLo) / 2;
+               if(Offset(tMid) == lOffset)
+                  tHi = tMid;
+               else
+                  tLo = tMid;
+            }
+            return tHi;
+         }
+         tHi = tLo;
+      }
+      return tTo;
+   }
+
+   // Start with the rule (if we're beyond the end of our table)
+   time_t tVal = tFrom;
+   if(m_hasRule && (m_trans.empty() || (int64_t)tVal >= m_trans.back()))
+   {
+      time_t tPrev;
+      while(RulePrev(tVal, tPrev) && tPrev > tTo &&
+            (m_trans.empty() || (int64_t)tPrev > m_trans.back()))
+      {
+         if(Offset(tPrev - 1) != lOffset)
+            return tPrev;
+         tVal = tPrev - 1;
+      }
+   }
+
+   // Then walk our table backwards
+   vector<int64_t>::const_iterator itr =
+      upper_bound(m_trans.begin(), m_trans.end(), (int64_t)tVal);
+   while(itr != m_trans.begin())
+   {
+      --itr;
+      if(*itr <= (int64_t)tTo)
+         break;
+      if(Offset((time_t)*itr - 1) != lOffset)
+         return (time_t)*itr;
+   }
+   return tTo;
+}
@@ -0,0 +1,143 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _TIME_ZONE_H
+#define _TIME_ZONE_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A TimeZone converts moments in time (time_t) into local (wall clock) time.
+//
+// A TimeZone is never modified once it has been constructed, so a single
+// instance can be shared by as many threads (and Date objects) as you like
+// without any locking.  Loading a zone by name reads its TZif file from the
+// zoneinfo database once; it does not touch the TZ environment variable.
+//
+// The default constructor (and TimeZone::Local()) defers to the system's
+// notion of local time through localtime_r().
+class TimeZone
+{
+   public:
+     // The system's local time
+     TimeZone();
+
+     // An IANA zone name (America/Toronto), the absolute path to a TZif
+     // file or a POSIX TZ string (EST5EDT,M3.2.0,M11.1.0)
+     explicit TimeZone(const string& sName);
+     ~TimeZone();
+
+     // Returns true if the zone was loaded successfully
+     const bool Valid() const;
+
+     // Returns the name the zone was loaded with ("" for the system zone)
+     const string& Name() const;
+
+     // Returns the offset (in seconds east of UTC) in effect at tVal
+     const long Offset(const time_t tVal) const;
+
+     // Breaks tVal down into local time; returns false if it could not be
+     const bool LocalTime(const time_t tVal, struct tm &tmOut) const;
+
+     // Returns the first moment in time (after tFrom and no later then tTo)
+     // where the UTC offset is no longer the one in effect at tFrom.  tTo+1
+     // is returned if the offset never changes in this period.
+     const time_t NextTransition(const time_t tFrom, const time_t tTo) const;
+
+     // Returns the moment in time (after tTo and no later then tFrom) from
+     // which the UTC offset in effect at tFrom has held.  tTo is returned if
+     // it held all the way back to tTo.
+     const time_t PrevTransition(const time_t tFrom, const time_t tTo) const;
+
+     // Shared instances; these are created the first time they are asked
+     // for and live for the duration of the program.
+     static const TimeZone& Local();
+     static const TimeZone& Utc();
+
+   private:
+     // A local time type (an offset and whether it is daylight savings)
+     struct ZoneType
+     {
+        long offset;
+        bool isDst;
+        size_t abbrev;
+     };
+
+     // One half of a POSIX TZ rule; when daylight savings starts or ends
+     struct ZoneRule
+     {
+        char kind;    // 'J' (1-365, no leap day), 'D' (0-365) or 'M'
+        int month;
+        int week;
+        int day;
+        long time;    // seconds after (local) midnight
+     };
+
+     string m_name;
+     bool m_valid;
+     bool m_system;
+
+     // Transitions read from the TZif file
+     vector<int64_t> m_trans;
+     vector<unsigned char> m_transType;
+     vector<ZoneType> m_types;
+     string m_abbrevs;
+
+     // The POSIX TZ rule used beyond the last transition
+     bool m_hasRule;
+     bool m_hasDst;
+     long m_stdOffset;
+     long m_dstOffset;
+     string m_stdAbbrev;
+     string m_dstAbbrev;
+     ZoneRule m_dstStart;
+     ZoneRule m_dstEnd;
+
+     const bool LoadFile(const string& sPath);
+     const bool LoadTZif(const string& sData);
+     const bool ParseRule(const string& sRule);
+
+     // Looks up the local time type in effect at tVal
+     void Lookup(const time_t tVal, long &lOffset, bool &isDst,
+                 const char* &szAbbrev) const;
+
+     // Daylight savings per the POSIX TZ rule
+     const bool RuleIsDst(const time_t tVal) const;
+     const bool RuleNext(const time_t tFrom, time_t &tNext) const;
+     const bool RulePrev(const time_t tFrom, time_t &tPrev) const;
+     void RuleYear(const int year, time_t &tStart, time_t &tEnd) const;
+};
+
+inline const bool TimeZone::Valid() const
+{
+   return m_valid;
+}
+
+inline const string& TimeZone::Name() const
+{
+   return m_name;
+}
+#endif
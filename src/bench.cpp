@@ -0,0 +1,396 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <time.h>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "Date.h"
+#include "CronSchedule.h"
+#include "CronCache.h"
+#include "DateFormat.h"
+#include "DateBatch.h"
+
+using namespace std;
+
+// Microbenchmarks for the date and cron calculations; run them with
+// 'make bench' which also stores the results (as JSON) in bench.json.
+//
+// Every benchmark starts from the same moment in time so the results can
+// be compared from one build to the next.
+namespace {
+   // 2017-07-14 02:40:00 UTC
+   const time_t BENCH_REF = 1500000000;
+
+   // Cron strings ranging from ones that match often (dense) to ones that
+   // rarely do (sparse)
+   const char* CRON_DENSE = "* * * * * * *";
+   const char* CRON_STEP = "/15 /5 * * * * *";
+   const char* CRON_LIST = "0 0,15,30,45 8-17 * * 1-5 *";
+   const char* CRON_SPARSE = "0 0 0 29 2 * *";
+   const char* CRON_DRIFT = "0 /5 * * * * +90";
+   const char* CRON_ISC = "30 4 1,15 * 5";
+}
+
+//------------------------------------------------
+//
+//  Function: BM_CronInt
+//
+//------------------------------------------------
+static void BM_CronInt(benchmark::State& state, int sec, int min, int hour,
+                       int dom, int month, int dow, int drift)
+{
+   Date dObj(BENCH_REF);
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(
+         dObj.Cron(sec, min, hour, dom, month, dow, drift).Time());
+   }
+}
+BENCHMARK_CAPTURE(BM_CronInt, dense, 0, -1, -1, -1, -1, -1, -1);
+BENCHMARK_CAPTURE(BM_CronInt, hourly, 0, 0, -1, -1, -1, -1, -1);
+BENCHMARK_CAPTURE(BM_CronInt, weekly, 0, 0, 0, -1, -1, 3, -1);
+BENCHMARK_CAPTURE(BM_CronInt, sparse, 0, 0, 0, 29, 2, -1, -1);
+BENCHMARK_CAPTURE(BM_CronInt, drift, 0, 0, -1, -1, -1, -1, 90);
+
+//------------------------------------------------
+//
+//  Function: BM_CronString
+//
+//------------------------------------------------
+static void BM_CronString(benchmark::State& state, const char* szCron,
+                          bool isISC)
+{
+   Date dObj(BENCH_REF);
+   const string sCron(szCron);
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(dObj.Cron(sCron, isISC).Time());
+   }
+}
+BENCHMARK_CAPTURE(BM_CronString, dense, CRON_DENSE, false);
+BENCHMARK_CAPTURE(BM_CronString, step, CRON_STEP, false);
+BENCHMARK_CAPTURE(BM_CronString, list, CRON_LIST, false);
+BENCHMARK_CAPTURE(BM_CronString, sparse, CRON_SPARSE, false);
+BENCHMARK_CAPTURE(BM_CronString, drift, CRON_DRIFT, false);
+BENCHMARK_CAPTURE(BM_CronString, isc, CRON_ISC, true);
+
+//------------------------------------------------
+//
+//  Function: BM_CronValid
+//
+//------------------------------------------------
+static void BM_CronValid(benchmark::State& state, const char* szCron,
+                         bool isISC)
+{
+   const string sCron(szCron);
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(Date::CronValid(sCron, isISC));
+   }
+}
+BENCHMARK_CAPTURE(BM_CronValid, list, CRON_LIST, false);
+BENCHMARK_CAPTURE(BM_CronValid, isc, CRON_ISC, true);
+BENCHMARK_CAPTURE(BM_CronValid, invalid, "0 0 * * 61", true);
+
+//------------------------------------------------
+//
+//  Function: BM_CronCompile
+//  (parsing without the cache)
+//
+//------------------------------------------------
+static void BM_CronCompile(benchmark::State& state, const char* szCron,
+                           bool isISC)
+{
+   const string sCron(szCron);
+   CronSchedule cron;
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(cron.Compile(sCron, isISC));
+   }
+}
+BENCHMARK_CAPTURE(BM_CronCompile, dense, CRON_DENSE, false);
+BENCHMARK_CAPTURE(BM_CronCompile, list, CRON_LIST, false);
+BENCHMARK_CAPTURE(BM_CronCompile, drift, CRON_DRIFT, false);
+BENCHMARK_CAPTURE(BM_CronCompile, isc, CRON_ISC, true);
+
+//------------------------------------------------
+//
+//  Function: BM_CronNext
+//  (a compiled schedule without the cache)
+//
+//------------------------------------------------
+static void BM_CronNext(benchmark::State& state, const char* szCron,
+                        bool isISC)
+{
+   const CronSchedule cron(szCron, isISC);
+   time_t tNext;
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(cron.Next(BENCH_REF, tNext));
+   }
+}
+BENCHMARK_CAPTURE(BM_CronNext, dense, CRON_DENSE, false);
+BENCHMARK_CAPTURE(BM_CronNext, list, CRON_LIST, false);
+BENCHMARK_CAPTURE(BM_CronNext, sparse, CRON_SPARSE, false);
+
+//------------------------------------------------
+//
+//  Function: BM_Str
+//
+//------------------------------------------------
+static void BM_Str(benchmark::State& state, const char* szFormat)
+{
+   Date dObj(BENCH_REF);
+   const string sFormat(szFormat);
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(dObj.Str(sFormat));
+   }
+}
+BENCHMARK_CAPTURE(BM_Str, default, "%Y-%m-%d %H:%M:%S");
+BENCHMARK_CAPTURE(BM_Str, date, "%Y%m%d");
+BENCHMARK_CAPTURE(BM_Str, names, "%A, %B %d %Y (%a %b)");
+BENCHMARK_CAPTURE(BM_Str, literal, "no format specifiers at all");
+BENCHMARK_CAPTURE(BM_Str, everything,
+                  "%a %A %b %B %c %C %d %D %H %I %j %k %l %m %M %p %r "
+                  "%R %s %S %T %u %U %w %x %X %y %Y");
+
+//------------------------------------------------
+//
+//  Function: BM_StrCompiled
+//  (the format is only parsed once)
+//
+//------------------------------------------------
+static void BM_StrCompiled(benchmark::State& state, const char* szFormat)
+{
+   Date dObj(BENCH_REF);
+   const DateFormat format(szFormat);
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(dObj.Str(format));
+   }
+}
+BENCHMARK_CAPTURE(BM_StrCompiled, default, "%Y-%m-%d %H:%M:%S");
+BENCHMARK_CAPTURE(BM_StrCompiled, names, "%A, %B %d %Y (%a %b)");
+
+//------------------------------------------------
+//
+//  Function: BM_Render
+//  (into a buffer of our own)
+//
+//------------------------------------------------
+static void BM_Render(benchmark::State& state)
+{
+   Date dObj(BENCH_REF);
+   const DateFormat format("%Y-%m-%d %H:%M:%S");
+   char szOut[64];
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(
+         format.Render(dObj.Tm(), dObj.Time(), szOut, sizeof(szOut)));
+   }
+}
+BENCHMARK(BM_Render);
+
+//------------------------------------------------
+//
+//  Function: BM_Parse
+//  (reported as bytes of text read per second)
+//
+//------------------------------------------------
+static void BM_Parse(benchmark::State& state, const char* szFormat)
+{
+   Date dObj(BENCH_REF);
+   const DateFormat format(szFormat);
+   const string sText = dObj.Str(format);
+   Date dParsed;
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(
+         dParsed.Parse(format, sText.data(), sText.size()));
+   }
+   state.SetBytesProcessed(state.iterations() * sText.size());
+}
+BENCHMARK_CAPTURE(BM_Parse, iso8601, "%Y-%m-%dT%H:%M:%S");
+BENCHMARK_CAPTURE(BM_Parse, names, "%A, %B %d %Y %H:%M:%S");
+
+//------------------------------------------------
+//
+//  Function: BM_AddMonth
+//
+//------------------------------------------------
+static void BM_AddMonth(benchmark::State& state)
+{
+   Date dObj(BENCH_REF);
+   const int months = (int)state.range(0);
+   while (state.KeepRunning())
+   {
+      Date dCalc(dObj);
+      benchmark::DoNotOptimize(dCalc.AddMonth(months));
+   }
+}
+BENCHMARK(BM_AddMonth)->Arg(1)->Arg(-1)->Arg(120)->Arg(-1200)->Arg(12000)
+                      ->Arg(120000);
+
+//------------------------------------------------
+//
+//  Function: BM_AddDOM
+//
+//------------------------------------------------
+static void BM_AddDOM(benchmark::State& state)
+{
+   Date dObj(BENCH_REF);
+   const int days = (int)state.range(0);
+   while (state.KeepRunning())
+   {
+      Date dCalc(dObj);
+      benchmark::DoNotOptimize(dCalc.AddDOM(days));
+   }
+}
+BENCHMARK(BM_AddDOM)->Arg(1)->Arg(-30)->Arg(36500);
+
+//------------------------------------------------
+//
+//  Function: BM_DateFields
+//  (one Date per moment in time; what DateBatch replaces)
+//
+//------------------------------------------------
+static void BM_DateFields(benchmark::State& state)
+{
+   const size_t count = (size_t)state.range(0);
+   vector<int> hour(count);
+   while (state.KeepRunning())
+   {
+      for(size_t index = 0; index < count; index++)
+      {
+         Date dObj(BENCH_REF + (time_t)index * 61);
+         hour[index] = dObj.Hour();
+      }
+      benchmark::DoNotOptimize(&hour[0]);
+   }
+   state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_DateFields)->Arg(4096);
+
+//------------------------------------------------
+//
+//  Function: BM_BatchToFields
+//
+//------------------------------------------------
+static void BM_BatchToFields(benchmark::State& state)
+{
+   const size_t count = (size_t)state.range(0);
+   vector<time_t> tIn(count);
+   vector<int> year(count), month(count), dom(count), hour(count),
+               min(count), sec(count), dow(count);
+   for(size_t index = 0; index < count; index++)
+      tIn[index] = BENCH_REF + (time_t)index * 61;
+
+   const DateFields fields = { &year[0], &month[0], &dom[0], &hour[0],
+                               &min[0], &sec[0], &dow[0] };
+   while (state.KeepRunning())
+   {
+      DateBatch::ToFields(&tIn[0], count, fields);
+      benchmark::DoNotOptimize(&year[0]);
+   }
+   state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BatchToFields)->Arg(4096);
+
+//------------------------------------------------
+//
+//  Function: BM_BatchToTimes
+//
+//------------------------------------------------
+static void BM_BatchToTimes(benchmark::State& state)
+{
+   const size_t count = (size_t)state.range(0);
+   vector<time_t> tIn(count), tOut(count);
+   vector<int> year(count), month(count), dom(count), hour(count),
+               min(count), sec(count);
+   for(size_t index = 0; index < count; index++)
+      tIn[index] = BENCH_REF + (time_t)index * 61;
+
+   const DateFields fields = { &year[0], &month[0], &dom[0], &hour[0],
+                               &min[0], &sec[0], NULL };
+   DateBatch::ToFields(&tIn[0], count, fields);
+   while (state.KeepRunning())
+   {
+      DateBatch::ToTimes(fields, count, &tOut[0]);
+      benchmark::DoNotOptimize(&tOut[0]);
+   }
+   state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BatchToTimes)->Arg(4096);
+
+//------------------------------------------------
+//
+//  Function: BM_CronMatches
+//  (one timestamp at a time)
+//
+//------------------------------------------------
+static void BM_CronMatches(benchmark::State& state, const char* szCron,
+                           bool isISC)
+{
+   const CronSchedule cron(szCron, isISC);
+   const size_t count = (size_t)state.range(0);
+   vector<time_t> tIn(count);
+   for(size_t index = 0; index < count; index++)
+      tIn[index] = BENCH_REF + (time_t)index * 61;
+
+   while (state.KeepRunning())
+   {
+      size_t matches = 0;
+      for(size_t index = 0; index < count; index++)
+         matches += cron.Matches(tIn[index]);
+      benchmark::DoNotOptimize(matches);
+   }
+   state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_CAPTURE(BM_CronMatches, list, CRON_LIST, false)->Arg(4096);
+
+//------------------------------------------------
+//
+//  Function: BM_CronMatchMask
+//  (the same timestamps as a column)
+//
+//------------------------------------------------
+static void BM_CronMatchMask(benchmark::State& state, const char* szCron,
+                             bool isISC)
+{
+   const CronSchedule cron(szCron, isISC);
+   const size_t count = (size_t)state.range(0);
+   vector<time_t> tIn(count);
+   vector<uint64_t> mask((count + 63) / 64);
+   for(size_t index = 0; index < count; index++)
+      tIn[index] = BENCH_REF + (time_t)index * 61;
+
+   while (state.KeepRunning())
+   {
+      benchmark::DoNotOptimize(cron.MatchMask(&tIn[0], count, &mask[0]));
+   }
+   state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_CAPTURE(BM_CronMatchMask, list, CRON_LIST, false)->Arg(4096);
+
+BENCHMARK_MAIN();
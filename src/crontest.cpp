@@ -0,0 +1,180 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include <time.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Date.h"
+#include "CronSchedule.h"
+using namespace std;
+
+/*
+ * Each schedule comes with a plain check of the wall clock that says
+ * whether a moment matches it; Next() and Prev() are compared against a
+ * second by second scan that uses nothing but that check.
+ */
+struct expression {
+   const char *cron[6];
+   bool (*matches)(const struct tm& tmVal);
+};
+
+bool EveryQuarterHour(const struct tm& t)
+{
+   return t.tm_sec == 0 && t.tm_min % 15 == 0;
+}
+
+bool WorkingHours(const struct tm& t)
+{
+   return t.tm_sec == 30 && t.tm_min == 0 && t.tm_hour >= 9 &&
+          t.tm_hour <= 17 && t.tm_wday >= 1 && t.tm_wday <= 5;
+}
+
+bool TwoInTheMorning(const struct tm& t)
+{
+   return t.tm_sec % 20 == 0 && (t.tm_min == 5 || t.tm_min == 35) &&
+          t.tm_hour == 2;
+}
+
+// The hour isn't specified but sits below the day of the month; so it is 0
+bool FirstOfTheMonth(const struct tm& t)
+{
+   return t.tm_sec == 15 && t.tm_min == 45 && t.tm_hour == 0 &&
+          t.tm_mday == 1;
+}
+
+bool LeapDay(const struct tm& t)
+{
+   return t.tm_sec == 0 && t.tm_min % 10 == 0 && t.tm_hour == 23 &&
+          t.tm_mday == 29 && t.tm_mon == 1;
+}
+
+const expression expressions[] =
+{
+   { {"0", "/15", "*", "*", "*", "*"}, EveryQuarterHour },
+   { {"30", "0", "9-17", "*", "*", "1-5"}, WorkingHours },
+   { {"/20", "5,35", "2", "*", "*", "*"}, TwoInTheMorning },
+   { {"15", "45", "*", "1", "*", "*"}, FirstOfTheMonth },
+   { {"0", "/10", "23", "29", "2", "*"}, LeapDay },
+};
+
+/*
+ * The three days scanned for each schedule (in UTC); between them they
+ * cross the end of a leap February and both of the daylight saving time
+ * changes in North America and Europe.
+ */
+const time_t windows[] =
+{
+   1709078400,      /* 2024-02-28 00:00:00 UTC */
+   1709942400,      /* 2024-03-09 00:00:00 UTC */
+   1711670400,      /* 2024-03-29 00:00:00 UTC */
+   1729900800,      /* 2024-10-26 00:00:00 UTC */
+   1730419200,      /* 2024-11-01 00:00:00 UTC */
+};
+const time_t WINDOW_LEN = 3 * 86400;
+
+/* Compares Next() and Prev() from every second of one window with the scan */
+unsigned Scan(const expression& expr, const time_t tStart)
+{
+   CronSchedule cron;
+   if(!cron.Compile(expr.cron[0], expr.cron[1], expr.cron[2],
+                    expr.cron[3], expr.cron[4], expr.cron[5]))
+   {
+      cerr << "FATAL: Cron " << expr.cron[0] << " " << expr.cron[1] << " "
+           << expr.cron[2] << " " << expr.cron[3] << " " << expr.cron[4]
+           << " " << expr.cron[5] << " is invalid." << endl;
+      return 1;
+   }
+
+   // Every second of the window that matches (on the wall clock)
+   vector<bool> isMatch(WINDOW_LEN);
+   for(time_t offset = 0; offset < WINDOW_LEN; offset++)
+   {
+      const time_t tVal = tStart + offset;
+      struct tm tmVal;
+      localtime_r(&tVal, &tmVal);
+      isMatch[offset] = expr.matches(tmVal);
+   }
+
+   // The next match after each second (where the window holds one)
+   unsigned failures = 0;
+   time_t tExpected = 0;
+   bool isKnown = false;
+   for(time_t offset = WINDOW_LEN - 1; offset >= 0; offset--)
+   {
+      const time_t tRef = tStart + offset;
+      time_t tNext;
+      if(isKnown && (!cron.Next(tRef, tNext) || tNext != tExpected))
+      {
+         cerr << "FATAL: " << expr.cron[0] << " " << expr.cron[1] << " "
+              << expr.cron[2] << " " << expr.cron[3] << " " << expr.cron[4]
+              << " " << expr.cron[5] << " Next(" << tRef << ") gave "
+              << tNext << " rather then " << tExpected << endl;
+         if(++failures > 10)
+            return failures;
+      }
+      if(isMatch[offset])
+      {
+         tExpected = tRef;
+         isKnown = true;
+      }
+   }
+
+   // The last match before each second (where the window holds one)
+   isKnown = false;
+   for(time_t offset = 0; offset < WINDOW_LEN; offset++)
+   {
+      const time_t tRef = tStart + offset;
+      time_t tPrev;
+      if(isKnown && (!cron.Prev(tRef, tPrev) || tPrev != tExpected))
+      {
+         cerr << "FATAL: " << expr.cron[0] << " " << expr.cron[1] << " "
+              << expr.cron[2] << " " << expr.cron[3] << " " << expr.cron[4]
+              << " " << expr.cron[5] << " Prev(" << tRef << ") gave "
+              << tPrev << " rather then " << tExpected << endl;
+         if(++failures > 10)
+            return failures;
+      }
+      if(isMatch[offset])
+      {
+         tExpected = tRef;
+         isKnown = true;
+      }
+   }
+   return failures;
+}
+
+int main(int argc, char **argv)
+{
+   unsigned failures = 0;
+   for (unsigned i=0; i < sizeof(expressions)/sizeof(expressions[0]); i++)
+   {
+      for (unsigned j=0; j < sizeof(windows)/sizeof(windows[0]); j++)
+      {
+         failures += Scan(expressions[i], windows[j]);
+      }
+   }
+
+   if(failures)
+   {
+      cerr << failures << " moments in time did not match a second by "
+           << "second scan" << endl;
+      return 1;
+   }
+   return 0;
+}
@@ -21,24 +21,61 @@
 #endif
 
 #include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <string>
+#include <limits>
+#include <algorithm>
 #include "Date.h"
+#include "DateFormat.h"
+#include "CronSchedule.h"
+#include "CronCache.h"
+#include "CronTable.h"
 #include "dateblock.h"
 
 #ifdef PYTHON_MODULE
    // Support python module for Crons
    #include "Python.h"
+   #include "structmember.h"
    #include "datetime.h"
 
-   // Support for DateTime Lookups
-   #ifdef IS_PY3K
-      #define PySideDateTime_IMPORT PyDateTime_IMPORT
+   #if PY_MAJOR_VERSION >= 3
+      #define IS_PY3K
+   #endif
+
+   // wait_async() hands the event loop a timer that is cancelled if the
+   // wall clock is set
+   #if defined(IS_PY3K) && defined(TFD_TIMER_CANCEL_ON_SET)
+      #define HAS_WAIT_ASYNC
+   #endif
+
+   // Python 3.7 and up hand us our arguments as a C array (with the names
+   // of any keywords in a tuple) rather then building a tuple and a dict
+   // for every call; see ParseArgs()
+   #if PY_VERSION_HEX >= 0x03070000
+      #define PY_ARGS PyObject *const *args, Py_ssize_t nargs, \
+                      PyObject *kwnames
+      #define PY_PARSE_ARGS(name, kwlist, required, values) \
+              ParseArgs(name, args, nargs, kwnames, NULL, \
+                        kwlist, required, values)
+      #define PY_METH_ARGS (METH_FASTCALL | METH_KEYWORDS)
    #else
-     #define PySideDateTime_IMPORT \
-             PyDateTimeAPI = (PyDateTime_CAPI*) PyCObject_Import((char*)"datetime", \
-                                                                 (char*)"datetime_CAPI")
+      #define PY_ARGS PyObject *args, PyObject *kwds
+      #define PY_PARSE_ARGS(name, kwlist, required, values) \
+              ParseArgs(name, PySequence_Fast_ITEMS(args), \
+                        PyTuple_GET_SIZE(args), NULL, kwds, \
+                        kwlist, required, values)
+      #define PY_METH_ARGS (METH_VARARGS | METH_KEYWORDS)
    #endif
 #else
    #include <boost/program_options.hpp>
@@ -100,7 +137,422 @@ unsigned long Block(unsigned long nsecs)
 
 }
 
+//------------------------------------------------
+//
+//  Function: BlockUntil
+//
+//  Desc: Blocks until the moment in time specified
+//
+//------------------------------------------------
+unsigned long BlockUntil(const time_t tDeadline, bool &isClockSet)
+{
+   isClockSet = false;
+
+#ifdef TFD_TIMER_CANCEL_ON_SET
+   // A timer that is cancelled if the wall clock is set (by NTP stepping
+   // it or by resuming from a suspend) so the caller can work out again
+   // when it should wake up rather then sleeping straight through it
+   const int fd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC);
+   if(fd >= 0)
+   {
+      struct itimerspec itsDeadline;
+      memset(&itsDeadline, 0, sizeof(itsDeadline));
+      itsDeadline.it_value.tv_sec = tDeadline;
+      if(timerfd_settime(fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET,
+                         &itsDeadline, NULL) == 0)
+      {
+         uint64_t expired;
+         const ssize_t rc = read(fd, &expired, sizeof(expired));
+         const int err = errno;
+         close(fd);
+
+         if(rc == (ssize_t)sizeof(expired))
+         {
+            return 0;
+         }
+
+         const time_t tNow = Date().Time();
+         if(tNow >= tDeadline)
+         {
+            // The clock was set past the deadline
+            return 0;
+         }
+         isClockSet = (err == ECANCELED);
+         return (unsigned long)(tDeadline - tNow);
+      }
+      close(fd);
+   }
+#endif
+
+#ifdef TIMER_ABSTIME
+   // Sleeping until an absolute moment on the wall clock wakes us up right
+   // as the second starts (rather then somewhere in it as alarm() does)
+   // and still holds if the clock is set while we sleep
+   struct timespec tsDeadline;
+   tsDeadline.tv_sec = tDeadline;
+   tsDeadline.tv_nsec = 0;
+   if(clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &tsDeadline, NULL) == 0)
+   {
+      return 0;
+   }
+#else
+   const time_t tStart = Date().Time();
+   if(tDeadline > tStart && Block(tDeadline - tStart) == 0)
+   {
+      return 0;
+   }
+#endif
+
+   // A signal was caught; return the (whole) seconds still left
+   const time_t tNow = Date().Time();
+   return (tNow >= tDeadline) ? 0 : (unsigned long)(tDeadline - tNow);
+}
+
 #ifndef PYTHON_MODULE
+//------------------------------------------------
+//
+//  Function: RunJob
+//
+//  Desc: Starts a job with the shell; we don't wait
+//        around for it to finish
+//
+//------------------------------------------------
+void RunJob(const string& sJob)
+{
+   const pid_t pid = fork();
+   if(pid == 0)
+   {
+      // Jobs get the default SIGCHLD handling back (see RunCronTable)
+      signal(SIGCHLD, SIG_DFL);
+      execl("/bin/sh", "sh", "-c", sJob.c_str(), (char *)NULL);
+      _exit(127);
+   }
+   else if(pid < 0)
+   {
+      cerr << "Error: Could not run '" << sJob << "'" << endl;
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: RunCronTable
+//
+//  Desc: Blocks until each of the schedules in the
+//        file specified comes due (forever)
+//
+//------------------------------------------------
+int RunCronTable(const string& sFile, bool isISC, bool isTest,
+                 bool isVerbose)
+{
+   ifstream fStream;
+   if(sFile != "-")
+   {
+      fStream.open(sFile.c_str());
+      if(!fStream)
+      {
+         cerr << "Error: Could not open '" << sFile << "'" << endl;
+         return 1;
+      }
+   }
+   istream &iStream = (sFile != "-") ? fStream : cin;
+
+   const Date dObjStart;
+   CronTable table(dObjStart.Zone());
+   string sLine;
+   for(unsigned lineNo = 1; getline(iStream, sLine); lineNo++)
+   {
+      if(!table.AddLine(sLine, isISC, dObjStart.Time()))
+      {
+         cerr << "Error: Syntax Invalid (line " << lineNo << ") : '"
+              << sLine << "'" << endl;
+         return 1;
+      }
+   }
+
+   if (isVerbose || isTest)
+   {
+      cout << "Current Time : "
+           << dObjStart.Str("%Y-%m-%d %H:%M:%S (%a)") << endl;
+      for(size_t index = 0; index < table.Size(); index++)
+      {
+         time_t tDue;
+         if(!table.NextDue(index, tDue))
+            continue;
+
+         cout << "Block Until  : "
+              << Date(tDue, dObjStart.Zone()).Str("%Y-%m-%d %H:%M:%S (%a)")
+              << " " << table.Cron(index);
+         if(!table.Job(index).empty())
+            cout << " " << table.Job(index);
+         cout << endl;
+      }
+   }
+
+   if (isTest)
+   {
+      return 0;
+   }
+
+   // Finished jobs are reaped for us
+   struct sigaction newact;
+   newact.sa_handler = SIG_IGN;
+   sigemptyset(&newact.sa_mask);
+   newact.sa_flags = SA_NOCLDWAIT;
+   sigaction(SIGCHLD, &newact, NULL);
+
+   time_t tDue;
+   while(table.NextDue(tDue))
+   {
+      const time_t tNow = Date().Time();
+      if(tDue > tNow)
+      {
+         // We may wake up early (a signal); if so just go back to sleep
+         // but if the wall clock was set then every schedule is worked
+         // out again from the new time
+         bool isClockSet;
+         BlockUntil(tDue, isClockSet);
+         if(isClockSet)
+         {
+            table.Reschedule(Date().Time());
+         }
+         continue;
+      }
+
+      size_t index;
+      while(table.Fire(tNow, index, tDue))
+      {
+         // A schedule without a job is simply written out when it is due
+         if(table.Job(index).empty() || isVerbose)
+         {
+            cout << Date(tDue, dObjStart.Zone()).Str("%Y-%m-%d %H:%M:%S")
+                 << " " << table.Cron(index);
+            if(!table.Job(index).empty())
+               cout << " " << table.Job(index);
+            cout << endl;
+         }
+
+         if(!table.Job(index).empty())
+            RunJob(table.Job(index));
+      }
+   }
+   return 0;
+}
+
+extern char **environ;
+
+//------------------------------------------------
+//
+//  Function: SpawnCommand
+//
+//  Desc: Starts the command specified (without a
+//        shell); returns its process id or -1 if
+//        it could not be started
+//
+//------------------------------------------------
+pid_t SpawnCommand(char *const argvCommand[])
+{
+   pid_t pid;
+   const int err = posix_spawnp(&pid, argvCommand[0], NULL, NULL,
+                                argvCommand, environ);
+   if(err != 0)
+   {
+      cerr << "Error: Could not run '" << argvCommand[0] << "' : "
+           << strerror(err) << endl;
+      return -1;
+   }
+   return pid;
+}
+
+//------------------------------------------------
+//
+//  Function: IsRunnable
+//
+//  Desc: Returns true if the command specified can
+//        be found (the way posix_spawnp() searches
+//        for it) and may be run
+//
+//------------------------------------------------
+bool IsRunnable(const char *szCommand)
+{
+   if(strchr(szCommand, '/') != NULL)
+   {
+      return access(szCommand, X_OK) == 0;
+   }
+
+   const char *szPath = getenv("PATH");
+   const string sPath = szPath ? szPath : "/bin:/usr/bin";
+   string::size_type pos = 0;
+   while(true)
+   {
+      const string::size_type end = sPath.find(':', pos);
+      string sDir = sPath.substr(pos, (end == string::npos) ?
+                                      string::npos : end - pos);
+      if(sDir.empty())
+         sDir = ".";
+      if(access((sDir + "/" + szCommand).c_str(), X_OK) == 0)
+         return true;
+      if(end == string::npos)
+         return false;
+      pos = end + 1;
+   }
+}
+
+//------------------------------------------------
+//
+//  Function: RunCommand
+//
+//  Desc: Runs the command specified each time the
+//        schedule comes due (forever).  The overlap
+//        policy decides what happens when it is due
+//        while the last run has yet to finish:
+//          skip  - that run is skipped
+//          queue - it runs as soon as the last one
+//                  finishes (runs that came due in
+//                  the meantime are folded into it)
+//          allow - it runs alongside it
+//
+//------------------------------------------------
+int RunCommand(const CronSchedule& cron, char *const argvCommand[],
+               const string& sOverlap, bool isVerbose)
+{
+   // A command that isn't there is a mistake worth stopping for; once we
+   // are running a run that fails to start (the host is short of memory
+   // or processes) is logged and we wait for the next one
+   if(!IsRunnable(argvCommand[0]))
+   {
+      cerr << "Error: Could not find '" << argvCommand[0] << "'" << endl;
+      return 127;
+   }
+
+   // The last run we started (while it is still running)
+   pid_t pidLast = -1;
+
+   time_t tRef = Date().Time();
+   time_t tDue;
+   while(cron.Next(tRef, tDue))
+   {
+      // We may wake up early (a signal); if so just go back to sleep
+      // but if the wall clock was set then the schedule is worked out
+      // again from the new time
+      time_t tNow;
+      while((tNow = Date().Time()) < tDue)
+      {
+         bool isClockSet;
+         BlockUntil(tDue, isClockSet);
+         if(isClockSet && !cron.Next(Date().Time(), tDue))
+         {
+            return 1;
+         }
+      }
+      tRef = tDue;
+
+      // Reap the runs that have finished
+      pid_t pid;
+      while((pid = waitpid(-1, NULL, WNOHANG)) > 0)
+      {
+         if(pid == pidLast)
+            pidLast = -1;
+      }
+
+      if(pidLast > 0 && sOverlap == "skip")
+      {
+         if(isVerbose)
+         {
+            cout << Date(tDue).Str("%Y-%m-%d %H:%M:%S")
+                 << " Skipped (still running) " << argvCommand[0] << endl;
+         }
+         continue;
+      }
+
+      if(pidLast > 0 && sOverlap == "queue")
+      {
+         waitpid(pidLast, NULL, 0);
+         pidLast = -1;
+
+         // Anything that came due while we waited is folded into this run
+         tRef = Date().Time();
+      }
+
+      pidLast = SpawnCommand(argvCommand);
+      if(pidLast < 0)
+      {
+         continue;
+      }
+
+      if(isVerbose)
+      {
+         cout << Date(tRef).Str("%Y-%m-%d %H:%M:%S")
+              << " " << argvCommand[0] << endl;
+      }
+   }
+   return 1;
+}
+
+// How many moments in time --count and --until work out at a time
+#define SERIES_BATCH 256
+
+//------------------------------------------------
+//
+//  Function: PrintSeries
+//
+//  Desc: Writes out (up to) count moments in time
+//        after the start (and no later then tUntil)
+//        that match the schedule; one per line
+//
+//------------------------------------------------
+int PrintSeries(const CronSchedule& cron, const Date& dObjStart,
+                size_t count, const time_t tUntil, const string& sFormat)
+{
+   const bool isEpoch = (sFormat == "epoch");
+   const bool isJson = (sFormat == "json");
+   const DateFormat format(isJson ? "%Y-%m-%d %H:%M:%S" : sFormat);
+
+   // The schedule is stepped through a batch at a time; each batch carries
+   // on from where the last one left off
+   time_t tBatch[SERIES_BATCH];
+   time_t tRef = dObjStart.Time();
+   Date dObj(dObjStart.Zone());
+   while(count)
+   {
+      const size_t batch = cron.Series(tRef, tBatch,
+                                       min(count, (size_t)SERIES_BATCH),
+                                       dObjStart.Zone());
+      for(size_t index = 0; index < batch; index++)
+      {
+         if(tBatch[index] > tUntil)
+         {
+            return 0;
+         }
+
+         if(isEpoch)
+         {
+            cout << (long long)tBatch[index] << '\n';
+            continue;
+         }
+
+         dObj.Set(tBatch[index]);
+         if(isJson)
+         {
+            cout << "{\"epoch\":" << (long long)tBatch[index]
+                 << ",\"time\":\"" << dObj.Str(format) << "\"}\n";
+         }
+         else
+         {
+            cout << dObj.Str(format) << '\n';
+         }
+      }
+
+      if(batch == 0)
+      {
+         // Nothing left matches the schedule
+         break;
+      }
+      count -= batch;
+      tRef = tBatch[batch - 1];
+   }
+   return 0;
+}
+
 //------------------------------------------------
 //
 //  Function: ProgramDetails
@@ -211,6 +663,20 @@ void ProgramExamples()
      << " 20th of the month) Hours divisible by 5 are: 0,"
      << endl <<  "     5,10,15 and 20."
      << endl << endl;
+
+   cerr << "$> dateblock -s /5 -e -- rsync -a /src/ /dst/" << endl
+     << "    This would run rsync every time a second divisible by 5 was"
+     << " reached (forever)." << endl
+     << "    A run that comes due while the last one is still going is"
+     << " skipped; use" << endl
+     << "    --overlap (-O) queue or allow to change that."
+     << endl << endl;
+
+   cerr << "$> dateblock -c \"0 0 12 * * 1-5\" -N 100 -f epoch" << endl
+     << "    This would write out (without blocking) the next 100 times noon"
+     << " is reached" << endl
+     << "    on a weekday as seconds since the epoch."
+     << endl << endl;
 }
 
 int main(int argc, char **argv)
@@ -228,6 +694,9 @@ int main(int argc, char **argv)
    string sDriftOffset="*";
    string sCronStr="";
 
+   // Kept around in case the schedule has to be worked out again
+   CronSchedule cron;
+
    // Declare the supported options.
    po::options_description poAllOptions("Allowed options");
    po::variables_map poVariablesMap;
@@ -245,15 +714,44 @@ int main(int argc, char **argv)
        ("dow,w", po::value<string>(), "Day of Week (0-6) {Sun=0,...,Sat=6}")
        ("cron,c", po::value<string>(), "Cron string formatting")
        ("drift,x", po::value<string>(), "Additional drift time (in seconds).")
+       ("table,T", po::value<string>(), "Run as a daemon; every line of the "
+        "file specified ('-' for stdin) holds a cron string (all of its "
+        "fields) followed by an optional command to run each time it is due.")
+       ("exec,e", "Run as a daemon; the command (and arguments) that follow "
+        "'--' are run each time the schedule is due.")
+       ("overlap,O", po::value<string>()->default_value("skip"), "What "
+        "--exec does when the command is due while the last run of it has "
+        "yet to finish: skip, queue (run it once the last run finishes) or "
+        "allow (run them alongside each other).")
+       ("count,N", po::value<long>(), "Write out the next N moments in "
+        "time the schedule is due (rather then blocking).")
+       ("until,U", po::value<string>(), "Write out every moment in time the "
+        "schedule is due up until the date specified (YYYY-MM-DD [HH:MM:SS] "
+        "or seconds since the epoch) rather then blocking.")
+       ("format,f", po::value<string>(), "How --count and --until write out "
+        "each moment in time: epoch, json (an object per line) or a date "
+        "format (see $>man date). The default is: %Y-%m-%d %H:%M:%S")
    ;
 
+   // Everything after '--' is the command --exec runs
+   int argcOptions = argc;
+   for(int index = 1; index < argc; index++)
+   {
+      if(strcmp(argv[index], "--") == 0)
+      {
+         argcOptions = index;
+         break;
+      }
+   }
+   char **argvCommand = argv + ((argcOptions < argc) ? argcOptions + 1 : argc);
+
    // Parse all the options and ensure the critical ones have been defined.
    // It's up to the application mainline to ensure application-specific
    // arguments have been specified on the command-line.
    try
    {
       po::store(
-            po::parse_command_line(argc, argv, poAllOptions),
+            po::parse_command_line(argcOptions, argv, poAllOptions),
             poVariablesMap);
    }
    catch(exception& e)
@@ -270,6 +768,13 @@ int main(int argc, char **argv)
       ProgramExamples();
       return 0;
    }
+   else if (poVariablesMap.count("table"))
+   {
+      return RunCronTable(poVariablesMap["table"].as<string>(),
+                          poVariablesMap.count("isc") > 0,
+                          poVariablesMap.count("test") > 0,
+                          poVariablesMap.count("verbose") > 0);
+   }
    else if (! ( (poVariablesMap.count("cron")) ||
          (poVariablesMap.count("second")) ||
          (poVariablesMap.count("minute")) ||
@@ -287,6 +792,30 @@ int main(int argc, char **argv)
       return 1;
    }
 
+   const string sOverlap = poVariablesMap["overlap"].as<string>();
+   if (poVariablesMap.count("exec") && !*argvCommand)
+   {
+      cerr << "Error: --exec needs a command to run (after '--')." << endl;
+      return 1;
+   }
+   else if (!poVariablesMap.count("exec") && *argvCommand)
+   {
+      cerr << "Error: A command (after '--') is only run with --exec."
+           << endl;
+      return 1;
+   }
+   else if (sOverlap != "skip" && sOverlap != "queue" && sOverlap != "allow")
+   {
+      cerr << "Error: --overlap must be one of skip, queue or allow." << endl;
+      return 1;
+   }
+   else if (poVariablesMap.count("count") &&
+            poVariablesMap["count"].as<long>() < 1)
+   {
+      cerr << "Error: --count must be 1 or more." << endl;
+      return 1;
+   }
+
    if (!poVariablesMap.count("cron"))
    {
       // Store Second
@@ -364,6 +893,13 @@ int main(int argc, char **argv)
                      sMonthOffset,
                      sDowOffset,
                      sDriftOffset);
+      cron.Compile(sSecOffset,
+                   sMinOffset,
+                   sHourOffset,
+                   sDomOffset,
+                   sMonthOffset,
+                   sDowOffset,
+                   sDriftOffset);
    }
    else
    {
@@ -374,10 +910,17 @@ int main(int argc, char **argv)
       sCronStr = poVariablesMap["cron"].as<string>();
       //cout << "Executing Cron(\""
       //     << sCronStr << "\");" << endl;
-      if(!Date::CronValid(sCronStr, useISC))
+      cron = CronCache::Global().Lookup(sCronStr, useISC);
+      if(!cron.Valid())
       {
-         cerr << "Error: Syntax Invalid : '"
-            << sCronStr << "'" << endl;
+         const string sError = "Error: Syntax Invalid : '";
+         cerr << sError << sCronStr << "'" << endl;
+         if(cron.ErrorPos() != string::npos)
+         {
+            // Point at the character we could not make sense of
+            cerr << string(sError.size() + cron.ErrorPos(), ' ')
+                 << "^" << endl;
+         }
             ProgramExamples();
          return 1;
       }
@@ -386,17 +929,73 @@ int main(int argc, char **argv)
    }
 
 
+   if (poVariablesMap.count("count") || poVariablesMap.count("until"))
+   {
+      // Every moment is worked out from the one schedule we just parsed
+      size_t count = (size_t)-1;
+      if (poVariablesMap.count("count"))
+      {
+         count = (size_t)poVariablesMap["count"].as<long>();
+      }
+
+      Date dObjUntil(dObjStart);
+      time_t tUntil = numeric_limits<time_t>::max();
+      if (poVariablesMap.count("until"))
+      {
+         const string sUntil = poVariablesMap["until"].as<string>();
+         if(!dObjUntil.Parse("%Y-%m-%d %H:%M:%S", sUntil) &&
+            !dObjUntil.Parse("%Y-%m-%d", sUntil) &&
+            !dObjUntil.Parse("%s", sUntil))
+         {
+            cerr << "Error: Could not make sense of --until '" << sUntil
+                 << "'" << endl;
+            return 1;
+         }
+         tUntil = dObjUntil.Time();
+      }
+
+      const string sFormat = poVariablesMap.count("format") ?
+         poVariablesMap["format"].as<string>() : "%Y-%m-%d %H:%M:%S";
+      return PrintSeries(cron, dObjStart, count, tUntil, sFormat);
+   }
+
    if (poVariablesMap.count("verbose") || poVariablesMap.count("test"))
    {
       cout << "Current Time : "<< dObjStart.Str("%Y-%m-%d %H:%M:%S (%a)") << endl;
       cout << "Block Until  : "<< dObjFinish.Str("%Y-%m-%d %H:%M:%S (%a)") << endl;
    }
 
-   if (!(poVariablesMap.count("test")))
+   if (poVariablesMap.count("exec") && !poVariablesMap.count("test"))
+   {
+      // The schedule stays compiled for as long as we run it
+      return RunCommand(cron, argvCommand, sOverlap,
+                        poVariablesMap.count("verbose") > 0);
+   }
+   else if (!(poVariablesMap.count("test")))
    {
-      if(dObjFinish.Time() > dObjStart.Time())
+      // If the wall clock is set while we block (NTP stepped it or we
+      // were suspended) then the schedule is worked out again from the new
+      // time rather then sleeping through (or past) it
+      while(dObjFinish.Time() > dObjStart.Time())
       {
-         Block(dObjFinish.Time()-dObjStart.Time());
+         bool isClockSet;
+         BlockUntil(dObjFinish.Time(), isClockSet);
+
+         time_t tNext;
+         dObjStart.Set();
+         if(!isClockSet || !cron.Next(dObjStart.Time(), tNext))
+         {
+            break;
+         }
+
+         dObjFinish = tNext;
+         if (poVariablesMap.count("verbose"))
+         {
+            cout << "Clock Set    : "
+                 << dObjStart.Str("%Y-%m-%d %H:%M:%S (%a)") << endl;
+            cout << "Block Until  : "
+                 << dObjFinish.Str("%Y-%m-%d %H:%M:%S (%a)") << endl;
+         }
       }
       Date dObjNow;
       if (poVariablesMap.count("verbose"))
@@ -408,30 +1007,774 @@ int main(int argc, char **argv)
    return 0;
 }
 #else
-/* Block for a specified cron period; return None if a failure occurs otherwise
- * return the date calculated (after blocking until that period of time).
- *
- * You can additionally use this function to just preform calculations if
- * you specify block=False
+/* Returns true if the keyword name specified is szName.
  */
-static PyObject* dateblock(PyObject *self, PyObject *args, PyObject *kwds)
+static bool KeywordIs(PyObject *pName, const char *szName)
 {
-   char *str;
-   PyObject *pCronObj = NULL;
-   PyObject *pBlockObj = Py_True;
-   PyObject *pIscObj = Py_False;
+#ifdef IS_PY3K
+   return PyUnicode_Check(pName) &&
+          PyUnicode_CompareWithASCIIString(pName, szName) == 0;
+#else
+   return PyString_Check(pName) &&
+          strcmp(PyString_AS_STRING(pName), szName) == 0;
+#endif
+}
 
-   static char* kwlist[] = {"cron", "block", "ref", "isc", NULL};
+/* Stores a keyword argument in the slot of values[] kwlist names for it.
+ * Returns false (with a TypeError set) if there is no such keyword or it
+ * was already passed in by position.
+ */
+static bool ParseKeyword(const char *szFunc, PyObject *pName,
+                         PyObject *pValue, const char *const *kwlist,
+                         const Py_ssize_t nargs, PyObject **values)
+{
+   for(Py_ssize_t index = 0; kwlist[index] != NULL; index++)
+   {
+      if(!KeywordIs(pName, kwlist[index]))
+      {
+         continue;
+      }
 
-   // Block Flag; By default we always block (true=block, false=no block)
-   bool block = true;
+      if(index < nargs)
+      {
+         PyErr_Format(PyExc_TypeError,
+               "%s() got multiple values for argument '%s'",
+               szFunc, kwlist[index]);
+         return false;
+      }
+      values[index] = pValue;
+      return true;
+   }
 
-   // use isc cron type (no seconds or drift in cron entry); by default we use
-   // the dateblock format
-   bool isc = false;
+   PyObject *pNameRepr = PyObject_Repr(pName);
+   if(pNameRepr != NULL)
+   {
+#ifdef IS_PY3K
+      PyErr_Format(PyExc_TypeError,
+            "%s() got an unexpected keyword argument %U",
+            szFunc, pNameRepr);
+#else
+      PyErr_Format(PyExc_TypeError,
+            "%s() got an unexpected keyword argument %s",
+            szFunc, PyString_AsString(pNameRepr));
+#endif
+      Py_DECREF(pNameRepr);
+   }
+   return false;
+}
 
-   // Reference Date/Time
-   PyObject *pDateObj = NULL;
+/* Sorts the arguments of a call into values[] (which holds the defaults
+ * going in) in the order kwlist names them; the keywords are either the
+ * last len(kwnames) entries of args (the vectorcall convention) or a dict.
+ * The first 'required' of them must be specified.  Returns false (with a
+ * TypeError set) if the arguments don't fit.
+ */
+static bool ParseArgs(const char *szFunc, PyObject *const *args,
+                      const Py_ssize_t nargs, PyObject *kwnames,
+                      PyObject *kwds, const char *const *kwlist,
+                      const Py_ssize_t required, PyObject **values)
+{
+   Py_ssize_t count = 0;
+   while(kwlist[count] != NULL)
+   {
+      count++;
+   }
+
+   if(nargs > count)
+   {
+      PyErr_Format(PyExc_TypeError,
+            "%s() takes at most %d arguments (%d given)",
+            szFunc, (int)count, (int)nargs);
+      return false;
+   }
+
+   for(Py_ssize_t index = 0; index < nargs; index++)
+   {
+      values[index] = args[index];
+   }
+
+   if(kwnames != NULL)
+   {
+      for(Py_ssize_t index = 0; index < PyTuple_GET_SIZE(kwnames); index++)
+      {
+         if(!ParseKeyword(szFunc, PyTuple_GET_ITEM(kwnames, index),
+                          args[nargs + index], kwlist, nargs, values))
+         {
+            return false;
+         }
+      }
+   }
+
+   if(kwds != NULL)
+   {
+      Py_ssize_t pos = 0;
+      PyObject *pName, *pValue;
+      while(PyDict_Next(kwds, &pos, &pName, &pValue))
+      {
+         if(!ParseKeyword(szFunc, pName, pValue, kwlist, nargs, values))
+         {
+            return false;
+         }
+      }
+   }
+
+   for(Py_ssize_t index = 0; index < required; index++)
+   {
+      if(values[index] == NULL)
+      {
+         PyErr_Format(PyExc_TypeError,
+               "%s() missing required argument '%s'",
+               szFunc, kwlist[index]);
+         return false;
+      }
+   }
+   return true;
+}
+
+/* Fetches the text of a cron string.  Returns false (with a TypeError set)
+ * if it isn't a string.
+ */
+static bool CronText(PyObject *pCronObj, const char *&szCron,
+                     Py_ssize_t &len)
+{
+#ifdef IS_PY3K
+   if(PyUnicode_Check(pCronObj))
+   {
+      szCron = PyUnicode_AsUTF8AndSize(pCronObj, &len);
+      return szCron != NULL;
+   }
+#else
+   if(PyString_Check(pCronObj))
+   {
+      szCron = PyString_AS_STRING(pCronObj);
+      len = PyString_GET_SIZE(pCronObj);
+      return true;
+   }
+#endif
+   PyErr_SetString(PyExc_TypeError, "Only strings accepted.");
+   return false;
+}
+
+/* Raises the SyntaxError for a cron that couldn't be compiled.
+ */
+static void CronError(const CronSchedule &cron)
+{
+   if(cron.ErrorPos() != string::npos)
+   {
+      PyErr_Format(PyExc_SyntaxError,
+            "The cron specified is not formatted correctly "
+            "(at position %lu).", (unsigned long)cron.ErrorPos());
+   }
+   else
+   {
+      PyErr_SetString(PyExc_SyntaxError,
+            "The cron specified is not formatted correctly.");
+   }
+}
+
+/* Sets dObj to the reference date specified (a datetime, date or time
+ * object or an epoch time); None leaves it alone.  Returns false (with a
+ * python exception set) if the reference date isn't supported.
+ */
+static bool RefToDate(PyObject *pDateObj, Date &dObj)
+{
+   if(pDateObj != Py_None)
+   {
+      /* A Reference Date was specified */
+      if(PyDateTime_CheckExact(pDateObj))
+      {
+         /* We got a datetime reference object */
+         dObj.Set(
+            PyDateTime_GET_YEAR(pDateObj),
+            PyDateTime_GET_MONTH(pDateObj),
+            PyDateTime_GET_DAY(pDateObj),
+            PyDateTime_DATE_GET_HOUR(pDateObj),
+            PyDateTime_DATE_GET_MINUTE(pDateObj),
+            PyDateTime_DATE_GET_SECOND(pDateObj)
+         );
+      }
+      else if (PyDate_CheckExact(pDateObj))
+      {
+         /* We got a date reference object */
+         dObj.Set(
+            PyDateTime_GET_YEAR(pDateObj),
+            PyDateTime_GET_MONTH(pDateObj),
+            PyDateTime_GET_DAY(pDateObj),
+            0, 0, 0);
+      }
+      else if (PyTime_CheckExact(pDateObj))
+      {
+         /* We got a time reference object */
+         dObj.Set(
+            dObj.Year(),
+            dObj.Month(),
+            dObj.DOM(),
+            PyDateTime_TIME_GET_HOUR(pDateObj),
+            PyDateTime_TIME_GET_MINUTE(pDateObj),
+            PyDateTime_TIME_GET_SECOND(pDateObj)
+         );
+      }
+      else if (PyLong_CheckExact(pDateObj))
+      {
+         /* We got EPOC Time Value */
+         dObj.Set((time_t) PyLong_AsUnsignedLongLongMask(pDateObj));
+      }
+#ifndef IS_PY3K
+      else if (PyInt_Check(pDateObj))
+      {
+         /* We got an ill formated EPOC time value; this will only
+          * happen until 2038 when the REAL Y2K takes in effect,
+          * at that point, we'll always get a Lon */
+         dObj.Set((time_t) PyInt_AsUnsignedLongLongMask(pDateObj));
+      }
+#endif
+      else
+      {
+         /* Unsupported reference date was specified */
+         PyErr_SetString(PyExc_SyntaxError,
+               "Reference date format is not supported.");
+         return false;
+      }
+      #ifdef DEBUG
+      cerr << "DEBUG Python::Reference('" <<
+         dObj.Year() <<
+         "-" << dObj.Month() <<
+         "-" << dObj.DOM() <<
+         " " << dObj.Hour() <<
+         ":" << dObj.Min() <<
+         ":" << dObj.Sec()
+            << ")" << endl;
+      #endif
+   }
+   return true;
+}
+
+/* Returns a (naive) python datetime object for the date specified.
+ */
+static PyObject* DateToPy(const Date &dObj)
+{
+   return PyDateTime_FromDateAndTime(dObj.Year(),
+                                     dObj.Month(),
+                                     dObj.DOM(),
+                                     dObj.Hour(),
+                                     dObj.Min(),
+                                     dObj.Sec(),
+                                     0);
+}
+
+/* Blocks (without holding the GIL) until tNext; if the wall clock is set
+ * in the meantime then tNext is worked out again from the new time.
+ * Returns the number of seconds still left if a signal cut it short.
+ * isFound is false (and tNext stale) if nothing matches the cron after
+ * the clock was set.
+ */
+static unsigned long BlockForCron(const CronSchedule &cron, time_t &tNext,
+                                  bool &isFound)
+{
+   bool isClockSet;
+   unsigned long unslept;
+
+   isFound = true;
+   Py_BEGIN_ALLOW_THREADS
+   unslept = BlockUntil(tNext, isClockSet);
+   while(unslept && isClockSet)
+   {
+      isFound = cron.Next(Date().Time(), tNext);
+      if(!isFound)
+      {
+         break;
+      }
+      unslept = BlockUntil(tNext, isClockSet);
+   }
+   Py_END_ALLOW_THREADS
+
+   return isClockSet ? 0 : unslept;
+}
+
+#ifdef IS_PY3K
+/* Returns true if the buffer specified holds native 64 bit integers.
+ */
+static bool IsInt64Buffer(const Py_buffer &buffer)
+{
+   const char *szFormat = buffer.format ? buffer.format : "B";
+   bool isNative = true;
+   if(*szFormat == '@' || *szFormat == '=')
+   {
+      szFormat++;
+   }
+   else if(*szFormat == '<' || *szFormat == '>' || *szFormat == '!')
+   {
+      isNative = ((*szFormat == '<') == (PY_LITTLE_ENDIAN != 0));
+      szFormat++;
+   }
+
+   return isNative && buffer.itemsize == 8 &&
+          (strcmp(szFormat, "q") == 0 || strcmp(szFormat, "l") == 0);
+}
+
+/* Returns an array.array('q') holding the next moment in time (seconds
+ * since the epoch) that matches the schedule after each of the ones in
+ * pRefsObj (anything that exports 64 bit integers through the buffer
+ * protocol; a NumPy int64 array for example).
+ */
+static PyObject* NextMany(const CronSchedule &cron, PyObject *pRefsObj)
+{
+   Py_buffer refs;
+   if(PyObject_GetBuffer(pRefsObj, &refs,
+                         PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0)
+   {
+      return NULL;
+   }
+
+   if(!IsInt64Buffer(refs))
+   {
+      PyBuffer_Release(&refs);
+      PyErr_SetString(PyExc_TypeError,
+            "The reference times must be 64 bit integers.");
+      return NULL;
+   }
+   const Py_ssize_t count = refs.len / refs.itemsize;
+
+   // array('q', [0]) * count
+   PyObject *pArrayMod = PyImport_ImportModule("array");
+   PyObject *pZero = pArrayMod ?
+      PyObject_CallMethod(pArrayMod, "array", "s(i)", "q", 0) : NULL;
+   PyObject *pOutObj = pZero ? PySequence_Repeat(pZero, count) : NULL;
+   Py_XDECREF(pZero);
+   Py_XDECREF(pArrayMod);
+
+   Py_buffer out;
+   if(pOutObj == NULL ||
+      PyObject_GetBuffer(pOutObj, &out, PyBUF_WRITABLE) < 0)
+   {
+      Py_XDECREF(pOutObj);
+      PyBuffer_Release(&refs);
+      return NULL;
+   }
+
+   const int64_t *tRef = (const int64_t *)refs.buf;
+   int64_t *tOut = (int64_t *)out.buf;
+   bool isFound = true;
+
+   Py_BEGIN_ALLOW_THREADS
+   // Nothing matches between a reference time and the match found for it
+   // so any reference that falls in between (as most of a sorted column
+   // will) has the same match; the schedule is only walked once for each
+   time_t tFrom = 0;
+   time_t tNext = 0;
+   for(Py_ssize_t index = 0; isFound && index < count; index++)
+   {
+      const time_t tVal = (time_t)tRef[index];
+      if(index == 0 || tVal < tFrom || tVal >= tNext)
+      {
+         isFound = cron.Next(tVal, tNext);
+         tFrom = tVal;
+      }
+      tOut[index] = (int64_t)tNext;
+   }
+   Py_END_ALLOW_THREADS
+
+   PyBuffer_Release(&out);
+   PyBuffer_Release(&refs);
+   if(!isFound)
+   {
+      Py_DECREF(pOutObj);
+      PyErr_SetString(PyExc_ValueError,
+            "No moment in time matches the cron specified.");
+      return NULL;
+   }
+   return pOutObj;
+}
+
+/* next_many(cron, refs, isc=False): the next moment in time that matches
+ * the cron after each of the reference times (seconds since the epoch)
+ * specified; see NextMany().
+ */
+static PyObject* next_many(PyObject *self, PY_ARGS)
+{
+   static const char *const kwlist[] = {"cron", "refs", "isc", NULL};
+   PyObject *values[] = {NULL, NULL, Py_False};
+   if(!PY_PARSE_ARGS("next_many", kwlist, 2, values))
+   {
+      return NULL;
+   }
+
+   const char *szCron;
+   Py_ssize_t len;
+   const int isc = PyObject_IsTrue(values[2]);
+   if(!CronText(values[0], szCron, len) || isc < 0)
+   {
+      return NULL;
+   }
+
+   CronSchedule cron;
+   Py_BEGIN_ALLOW_THREADS
+   cron = CronCache::Global().Lookup(string(szCron, (size_t)len), isc != 0);
+   Py_END_ALLOW_THREADS
+   if(!cron.Valid())
+   {
+      CronError(cron);
+      return NULL;
+   }
+   return NextMany(cron, values[1]);
+}
+#endif
+
+#ifdef HAS_WAIT_ASYNC
+/* The state behind the future wait_async() hands back: a timerfd set for
+ * the next match that the running event loop watches on our behalf.
+ */
+typedef struct
+{
+   PyObject_HEAD
+   CronSchedule *cron;
+   time_t tNext;
+   int fd;
+   PyObject *pLoop;
+   PyObject *pFuture;
+} AsyncWaitObject;
+
+/* Sets the timer to go off at tNext (straight away if it has passed); it is
+ * cancelled (read() fails with ECANCELED) if the wall clock is set.
+ */
+static bool AsyncWaitArm(AsyncWaitObject *self)
+{
+   struct itimerspec itsDeadline;
+   memset(&itsDeadline, 0, sizeof(itsDeadline));
+   itsDeadline.it_value.tv_sec = self->tNext;
+   return timerfd_settime(self->fd,
+                          TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET,
+                          &itsDeadline, NULL) == 0;
+}
+
+/* Stops the event loop watching our timer and closes it; only the first
+ * call does anything.
+ */
+static bool AsyncWaitRelease(AsyncWaitObject *self)
+{
+   if(self->fd < 0)
+   {
+      return true;
+   }
+
+   PyObject *pRc = PyObject_CallMethod(self->pLoop, "remove_reader", "i",
+                                       self->fd);
+   close(self->fd);
+   self->fd = -1;
+   Py_XDECREF(pRc);
+   return pRc != NULL;
+}
+
+/* Called by the event loop when our timer can be read; the future is given
+ * the moment in time we waited for (unless it was cancelled meanwhile).
+ */
+static PyObject* AsyncWait_ready(AsyncWaitObject *self, PyObject *args)
+{
+   if(self->fd < 0)
+   {
+      Py_RETURN_NONE;
+   }
+
+   uint64_t expired;
+   if(read(self->fd, &expired, sizeof(expired)) != (ssize_t)sizeof(expired))
+   {
+      if(errno != ECANCELED)
+      {
+         // Woken up for nothing (EAGAIN)
+         Py_RETURN_NONE;
+      }
+
+      // The wall clock was set; unless that took us past the match we were
+      // waiting for, work out when we are due from the new time
+      const time_t tNow = Date().Time();
+      if(tNow < self->tNext)
+      {
+         if(!self->cron->Next(tNow, self->tNext))
+         {
+            PyErr_SetString(PyExc_ValueError,
+                  "No moment in time matches the cron specified.");
+            return NULL;
+         }
+         if(!AsyncWaitArm(self))
+         {
+            return PyErr_SetFromErrno(PyExc_OSError);
+         }
+         Py_RETURN_NONE;
+      }
+   }
+
+   if(!AsyncWaitRelease(self))
+   {
+      return NULL;
+   }
+
+   PyObject *pDone = PyObject_CallMethod(self->pFuture, "done", NULL);
+   if(pDone == NULL)
+   {
+      return NULL;
+   }
+   const bool isDone = (pDone == Py_True);
+   Py_DECREF(pDone);
+   if(isDone)
+   {
+      Py_RETURN_NONE;
+   }
+
+   PyObject *pResult = DateToPy(Date(self->tNext));
+   if(pResult == NULL)
+   {
+      return NULL;
+   }
+   PyObject *pRc = PyObject_CallMethod(self->pFuture, "set_result", "O",
+                                       pResult);
+   Py_DECREF(pResult);
+   return pRc;
+}
+
+/* Called once the future is done; if it was cancelled our timer is still
+ * being watched.
+ */
+static PyObject* AsyncWait_done(AsyncWaitObject *self, PyObject *pFuture)
+{
+   if(!AsyncWaitRelease(self))
+   {
+      return NULL;
+   }
+   Py_RETURN_NONE;
+}
+
+static int AsyncWait_traverse(AsyncWaitObject *self, visitproc visit,
+                              void *arg)
+{
+   Py_VISIT(self->pLoop);
+   Py_VISIT(self->pFuture);
+   return 0;
+}
+
+static int AsyncWait_clear(AsyncWaitObject *self)
+{
+   Py_CLEAR(self->pLoop);
+   Py_CLEAR(self->pFuture);
+   return 0;
+}
+
+static void AsyncWait_dealloc(AsyncWaitObject *self)
+{
+   PyObject_GC_UnTrack(self);
+   if(self->fd >= 0)
+   {
+      close(self->fd);
+   }
+   delete self->cron;
+   AsyncWait_clear(self);
+   PyObject_GC_Del(self);
+}
+
+static PyMethodDef AsyncWaitMethods[] =
+{
+    {"_ready", (PyCFunction)AsyncWait_ready, METH_NOARGS,
+                  "The timer went off"},
+    {"_done", (PyCFunction)AsyncWait_done, METH_O,
+                  "The future is done"},
+    /* sentinel */
+    {NULL, NULL }
+};
+
+static PyTypeObject AsyncWaitType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "dateblock._AsyncWait",                    /* tp_name */
+    sizeof(AsyncWaitObject),                   /* tp_basicsize */
+    0,                                         /* tp_itemsize */
+    (destructor)AsyncWait_dealloc,             /* tp_dealloc */
+    0,                                         /* tp_print */
+    0,                                         /* tp_getattr */
+    0,                                         /* tp_setattr */
+    0,                                         /* tp_compare */
+    0,                                         /* tp_repr */
+    0,                                         /* tp_as_number */
+    0,                                         /* tp_as_sequence */
+    0,                                         /* tp_as_mapping */
+    0,                                         /* tp_hash */
+    0,                                         /* tp_call */
+    0,                                         /* tp_str */
+    0,                                         /* tp_getattro */
+    0,                                         /* tp_setattro */
+    0,                                         /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,   /* tp_flags */
+    "A timer the event loop watches for wait_async()", /* tp_doc */
+    (traverseproc)AsyncWait_traverse,          /* tp_traverse */
+    (inquiry)AsyncWait_clear,                  /* tp_clear */
+    0,                                         /* tp_richcompare */
+    0,                                         /* tp_weaklistoffset */
+    0,                                         /* tp_iter */
+    0,                                         /* tp_iternext */
+    AsyncWaitMethods,                          /* tp_methods */
+};
+
+/* Calls pObj.szMethod(pObj.szCallback) for the callback (a bound method of
+ * ours) named.
+ */
+static bool AsyncWaitRegister(PyObject *pObj, const char *szMethod,
+                              PyObject *pArg, AsyncWaitObject *self,
+                              const char *szCallback)
+{
+   PyObject *pCallback = PyObject_GetAttrString((PyObject *)self,
+                                                szCallback);
+   if(pCallback == NULL)
+   {
+      return false;
+   }
+
+   PyObject *pRc = pArg ?
+      PyObject_CallMethod(pObj, szMethod, "OO", pArg, pCallback) :
+      PyObject_CallMethod(pObj, szMethod, "O", pCallback);
+   Py_DECREF(pCallback);
+   Py_XDECREF(pRc);
+   return pRc != NULL;
+}
+
+/* Returns a future (of the running asyncio event loop) that is given the
+ * next moment in time that matches the schedule once it arrives.  No
+ * thread or signal is involved; the loop simply watches a timerfd for us
+ * alongside everything else it is waiting on.
+ */
+static PyObject* WaitAsync(const CronSchedule &cron)
+{
+   const Date dObjNow;
+   time_t tNext;
+   if(!cron.Next(dObjNow.Time(), tNext))
+   {
+      PyErr_SetString(PyExc_ValueError,
+            "No moment in time matches the cron specified.");
+      return NULL;
+   }
+
+   PyObject *pAsyncio = PyImport_ImportModule("asyncio");
+   if(pAsyncio == NULL)
+   {
+      return NULL;
+   }
+#if PY_VERSION_HEX >= 0x03070000
+   PyObject *pLoop = PyObject_CallMethod(pAsyncio, "get_running_loop", NULL);
+#else
+   PyObject *pLoop = PyObject_CallMethod(pAsyncio, "get_event_loop", NULL);
+#endif
+   Py_DECREF(pAsyncio);
+   if(pLoop == NULL)
+   {
+      return NULL;
+   }
+
+   AsyncWaitObject *self = PyObject_GC_New(AsyncWaitObject, &AsyncWaitType);
+   if(self == NULL)
+   {
+      Py_DECREF(pLoop);
+      return NULL;
+   }
+   self->cron = new CronSchedule(cron);
+   self->tNext = tNext;
+   self->pLoop = pLoop;
+   self->pFuture = NULL;
+   self->fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+   PyObject_GC_Track(self);
+
+   if(self->fd < 0 || !AsyncWaitArm(self))
+   {
+      PyErr_SetFromErrno(PyExc_OSError);
+      Py_DECREF(self);
+      return NULL;
+   }
+
+   self->pFuture = PyObject_CallMethod(pLoop, "create_future", NULL);
+   if(self->pFuture == NULL)
+   {
+      Py_DECREF(self);
+      return NULL;
+   }
+
+   PyObject *pFd = PyLong_FromLong(self->fd);
+   if(pFd == NULL ||
+      !AsyncWaitRegister(pLoop, "add_reader", pFd, self, "_ready"))
+   {
+      // The loop isn't watching it yet; don't ask it to stop
+      Py_XDECREF(pFd);
+      close(self->fd);
+      self->fd = -1;
+      Py_DECREF(self);
+      return NULL;
+   }
+   Py_DECREF(pFd);
+
+   if(!AsyncWaitRegister(self->pFuture, "add_done_callback", NULL, self,
+                         "_done"))
+   {
+      AsyncWaitRelease(self);
+      Py_DECREF(self);
+      return NULL;
+   }
+
+   // The loop (and the future) keep us around for as long as they need us
+   PyObject *pFuture = self->pFuture;
+   Py_INCREF(pFuture);
+   Py_DECREF(self);
+   return pFuture;
+}
+
+/* wait_async(cron, isc=False): an awaitable that is given the next moment
+ * in time that matches the cron once it arrives; see WaitAsync().
+ */
+static PyObject* wait_async(PyObject *self, PY_ARGS)
+{
+   static const char *const kwlist[] = {"cron", "isc", NULL};
+   PyObject *values[] = {NULL, Py_False};
+   if(!PY_PARSE_ARGS("wait_async", kwlist, 1, values))
+   {
+      return NULL;
+   }
+
+   const char *szCron;
+   Py_ssize_t len;
+   const int isc = PyObject_IsTrue(values[1]);
+   if(!CronText(values[0], szCron, len) || isc < 0)
+   {
+      return NULL;
+   }
+
+   CronSchedule cron;
+   Py_BEGIN_ALLOW_THREADS
+   cron = CronCache::Global().Lookup(string(szCron, (size_t)len), isc != 0);
+   Py_END_ALLOW_THREADS
+   if(!cron.Valid())
+   {
+      CronError(cron);
+      return NULL;
+   }
+   return WaitAsync(cron);
+}
+#endif
+
+/* Block for a specified cron period; return None if a failure occurs otherwise
+ * return the date calculated (after blocking until that period of time).
+ *
+ * You can additionally use this function to just preform calculations if
+ * you specify block=False
+ */
+static PyObject* dateblock(PyObject *self, PY_ARGS)
+{
+   const char *str;
+   Py_ssize_t len;
+
+   // cron, block, ref and isc (in that order)
+   static const char *const kwlist[] = {"cron", "block", "ref", "isc", NULL};
+   PyObject *values[] = {NULL, Py_True, NULL, Py_False};
+
+   // Block Flag; By default we always block (true=block, false=no block)
+   bool block = true;
+
+   // use isc cron type (no seconds or drift in cron entry); by default we use
+   // the dateblock format
+   bool isc = false;
 
    // Time initializes to 'Now'
    Date dObjStart;
@@ -445,190 +1788,571 @@ static PyObject* dateblock(PyObject *self, PyObject *args, PyObject *kwds)
    // Finish time will be adjusted below base on cron value specified
    Date dObjFinish;
 
-   if(!PyArg_ParseTupleAndKeywords(args, kwds, "O|OOO", kwlist,
-            &pCronObj, &pBlockObj, &pDateObj, &pIscObj))
+   if(!PY_PARSE_ARGS("dateblock", kwlist, 1, values))
+   {
+      // Couldn't parse content
+      return NULL;
+   }
+
+   PyObject *pCronObj = values[0];
+   PyObject *pBlockObj = values[1];
+   PyObject *pDateObj = values[2];
+   PyObject *pIscObj = values[3];
+
+   /* Acquire String */
+   if(!CronText(pCronObj, str, len))
+   {
+      return NULL;
+   }
+
+   if (!PyDateTimeAPI)
+      /* Since we are dealing with python datetime objects, the following step
+       * is VERY IMPORTANT or the code will crash on the below checks since they
+       * will internally reference values that have not been initialized */
+      PyDateTime_IMPORT;
+
+   if(pDateObj != NULL && !RefToDate(pDateObj, dObjStart))
+   {
+      return NULL;
+   }
+
+   /* Determine if we are blocking or not (and if we are using the isc
+    * format); anything python considers true will do */
+   const int isBlock = PyObject_IsTrue(pBlockObj);
+   const int isIsc = PyObject_IsTrue(pIscObj);
+   if(isBlock < 0 || isIsc < 0)
    {
-      // Couldn't parse content
       return NULL;
    }
+   block = (isBlock != 0);
+   isc = (isIsc != 0);
+
+   #ifdef DEBUG
+   cerr << "DEBUG Python::dateblock('" << str
+      << "', isc=" << (string) (isc?"y":"n")
+      << ",block=" << (string) (block?"y":"n") << endl;
+   #endif
 
-   if(!PyString_Check(pCronObj))
+   // Parse our cron once (or fetch it from the cache if it was parsed by
+   // an earlier call); it is used to both validate and calculate.  None of
+   // this touches python so other threads are free to run meanwhile.
+   CronSchedule cron;
+   time_t tNext;
+   bool isValid;
+   Py_BEGIN_ALLOW_THREADS
+   cron = CronCache::Global().Lookup(string(str, (size_t)len), isc);
+   isValid = cron.Next(dObjStart.Time(), tNext);
+   Py_END_ALLOW_THREADS
+   if(!isValid)
    {
-      // Raise TypeError Exception
-      PyErr_SetString(PyExc_TypeError, "Only strings accepted.");
+      // Raise SyntaxError Exception
+      CronError(cron);
       return NULL;
    }
 
-   if (!PyDateTimeAPI)
-      /* Since we are dealing with python datetime objects, the following step
-       * is VERY IMPORTANT or the code will crash on the below checks since they
-       * will internally reference values that have not been initialized */
-      PyDateTime_IMPORT;
+   dObjFinish = tNext;
 
-   if(pDateObj != NULL)
+   if(block && dObjFinish.Time() > dObjRef.Time())
    {
-      if(pDateObj != Py_None)
+      bool isFound;
+      const unsigned long unslept = BlockForCron(cron, tNext, isFound);
+      if(!isFound)
       {
-         /* A Reference Date was specified */
-         if(PyDateTime_CheckExact(pDateObj))
-         {
-            /* We got a datetime reference object */
-            dObjStart.Set(
-               PyDateTime_GET_YEAR(pDateObj),
-               PyDateTime_GET_MONTH(pDateObj),
-               PyDateTime_GET_DAY(pDateObj),
-               PyDateTime_DATE_GET_HOUR(pDateObj),
-               PyDateTime_DATE_GET_MINUTE(pDateObj),
-               PyDateTime_DATE_GET_SECOND(pDateObj)
-            );
-         }
-         else if (PyDate_CheckExact(pDateObj))
-         {
-            /* We got a date reference object */
-            dObjStart.Set(
-               PyDateTime_GET_YEAR(pDateObj),
-               PyDateTime_GET_MONTH(pDateObj),
-               PyDateTime_GET_DAY(pDateObj),
-               0, 0, 0);
-         }
-         else if (PyTime_CheckExact(pDateObj))
-         {
-            /* We got a time reference object */
-            dObjStart.Set(
-               dObjStart.Year(),
-               dObjStart.Month(),
-               dObjStart.DOM(),
-               PyDateTime_TIME_GET_HOUR(pDateObj),
-               PyDateTime_TIME_GET_MINUTE(pDateObj),
-               PyDateTime_TIME_GET_SECOND(pDateObj)
-            );
-         }
-         else if (PyLong_CheckExact(pDateObj))
-         {
-            /* We got EPOC Time Value */
-            dObjStart.Set((time_t) PyLong_AsUnsignedLongLongMask(pDateObj));
-         }
-         else if (PyInt_Check(pDateObj))
-         {
-            /* We got an ill formated EPOC time value; this will only
-             * happen until 2038 when the REAL Y2K takes in effect,
-             * at that point, we'll always get a Lon */
-            dObjStart.Set((time_t) PyInt_AsUnsignedLongLongMask(pDateObj));
-         }
-         else
-         {
-            /* Unsupported reference date was specified */
-            PyErr_SetString(PyExc_SyntaxError,
-                  "Reference date format is not supported.");
-            return NULL;
-         }
-         #ifdef DEBUG
-         cerr << "DEBUG Python::Reference('" <<
-            dObjStart.Year() <<
-            "-" << dObjStart.Month() <<
-            "-" << dObjStart.DOM() <<
-            " " << dObjStart.Hour() <<
-            ":" << dObjStart.Min() <<
-            ":" << dObjStart.Sec()
-               << ")" << endl;
-         #endif
+         PyErr_SetString(PyExc_ValueError,
+               "No moment in time matches the cron specified.");
+         return NULL;
+      }
+      dObjFinish = tNext;
+      if(unslept)
+      {
+         // Simply put, if block is interupted by any
+         // means, we need to return this to the python
+         // tool calling it. BlockUntil() returns the amount of
+         // time still left to drift for; therfore we reached
+         // here because a non-zero value was returned
+         Py_RETURN_NONE;
       }
    }
 
-   /* Acquire String */
-   str = PyString_AsString(pCronObj);
-   if(str == NULL)
+   // Return Finish Date/Time
+   return DateToPy(dObjFinish);
+}
+
+/* How many moments in time a Schedule iterator works out at a time (each
+ * batch is calculated without holding the GIL).
+ */
+#define SCHEDULE_ITER_BATCH 16
+
+/* dateblock.Schedule: a cron string that is parsed exactly once and can
+ * then be asked for the moments in time that match it as often as you like.
+ */
+typedef struct
+{
+   PyObject_HEAD
+   CronSchedule *cron;
+   PyObject *pCronObj;
+   PyObject *pIscObj;
+} ScheduleObject;
+
+/* The iterator returned by Schedule.iter() */
+typedef struct
+{
+   PyObject_HEAD
+   ScheduleObject *pSchedule;
+   time_t tRef;
+   time_t tBatch[SCHEDULE_ITER_BATCH];
+   size_t index;
+   size_t count;
+} ScheduleIterObject;
+
+#ifdef IS_PY3K
+/* Schedule.next_many(refs): see next_many()
+ */
+static PyObject* Schedule_next_many(ScheduleObject *self, PyObject *pRefsObj)
+{
+   return NextMany(*self->cron, pRefsObj);
+}
+#endif
+
+#ifdef HAS_WAIT_ASYNC
+/* Schedule.wait_async(): see wait_async()
+ */
+static PyObject* Schedule_wait_async(ScheduleObject *self, PyObject *args)
+{
+   return WaitAsync(*self->cron);
+}
+#endif
+
+static void ScheduleIter_dealloc(ScheduleIterObject *self)
+{
+   Py_XDECREF(self->pSchedule);
+   PyObject_Del(self);
+}
+
+static PyObject* ScheduleIter_next(ScheduleIterObject *self)
+{
+   if(self->index == self->count)
+   {
+      // Work out the next batch of them in one go
+      size_t count;
+      Py_BEGIN_ALLOW_THREADS
+      count = self->pSchedule->cron->Series(self->tRef, self->tBatch,
+                                            SCHEDULE_ITER_BATCH);
+      Py_END_ALLOW_THREADS
+      if(count == 0)
+      {
+         // StopIteration
+         return NULL;
+      }
+      self->index = 0;
+      self->count = count;
+      self->tRef = self->tBatch[count - 1];
+   }
+   return DateToPy(Date(self->tBatch[self->index++]));
+}
+
+static PyTypeObject ScheduleIterType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "dateblock.ScheduleIterator",              /* tp_name */
+    sizeof(ScheduleIterObject),                /* tp_basicsize */
+    0,                                         /* tp_itemsize */
+    (destructor)ScheduleIter_dealloc,          /* tp_dealloc */
+    0,                                         /* tp_print */
+    0,                                         /* tp_getattr */
+    0,                                         /* tp_setattr */
+    0,                                         /* tp_compare */
+    0,                                         /* tp_repr */
+    0,                                         /* tp_as_number */
+    0,                                         /* tp_as_sequence */
+    0,                                         /* tp_as_mapping */
+    0,                                         /* tp_hash */
+    0,                                         /* tp_call */
+    0,                                         /* tp_str */
+    0,                                         /* tp_getattro */
+    0,                                         /* tp_setattro */
+    0,                                         /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags */
+    "Moments in time that match a Schedule",   /* tp_doc */
+    0,                                         /* tp_traverse */
+    0,                                         /* tp_clear */
+    0,                                         /* tp_richcompare */
+    0,                                         /* tp_weaklistoffset */
+    PyObject_SelfIter,                         /* tp_iter */
+    (iternextfunc)ScheduleIter_next,           /* tp_iternext */
+};
+
+/* Compiles the cron specified into a new Schedule object; raises a
+ * SyntaxError if it can't be parsed.
+ */
+static PyObject* ScheduleCreate(PyTypeObject *type, PyObject *pCronObj,
+                                PyObject *pIscObj)
+{
+   const char *szCron;
+   Py_ssize_t len;
+   if(!CronText(pCronObj, szCron, len))
    {
-      PyErr_SetString(PyExc_SyntaxError,
-            "The cron specified is not formatted correctly.");
       return NULL;
    }
 
-   /* Determine if we are blocking or not */
-   if(PyBool_Check(pBlockObj))
+   const int isc = PyObject_IsTrue(pIscObj);
+   if(isc < 0)
    {
-      block = (bool) ((PyBoolObject *) pBlockObj)->ob_ival;
+      return NULL;
    }
-   else if (PyInt_Check(pBlockObj))
+
+   CronSchedule *cron = new CronSchedule();
+   if(!cron->Compile(szCron, (size_t)len, isc != 0))
    {
-      // We'll be kind to those who ignore the fact that we're
-      // expecting a bool and treat integers as we would booleans
-      // smart developers will never cause this part of the code
-      // to be reached :)
-      block = (PyInt_AS_LONG(pBlockObj) != 0);
+      CronError(*cron);
+      delete cron;
+      return NULL;
    }
 
-   /* Determine if we are using isc format or not */
-   if(PyBool_Check(pIscObj))
+   ScheduleObject *self = (ScheduleObject *)type->tp_alloc(type, 0);
+   if(self == NULL)
    {
-      isc = (bool) ((PyBoolObject *) pIscObj)->ob_ival;
+      delete cron;
+      return NULL;
    }
-   else if (PyInt_Check(pIscObj))
+
+   self->cron = cron;
+   Py_INCREF(pCronObj);
+   self->pCronObj = pCronObj;
+   self->pIscObj = PyBool_FromLong(isc);
+   return (PyObject *)self;
+}
+
+/* Schedule(cron, isc=False)
+ */
+static const char *const ScheduleKwlist[] = {"cron", "isc", NULL};
+
+static PyObject* Schedule_new(PyTypeObject *type, PyObject *args,
+                              PyObject *kwds)
+{
+   PyObject *values[] = {NULL, Py_False};
+   if(!ParseArgs("Schedule", PySequence_Fast_ITEMS(args),
+                 PyTuple_GET_SIZE(args), NULL, kwds, ScheduleKwlist, 1,
+                 values))
    {
-      // We'll be kind to those who ignore the fact that we're
-      // expecting a bool and treat integers as we would booleans
-      // smart developers will never cause this part of the code
-      // to be reached :)
-      isc = (PyInt_AS_LONG(pIscObj) != 0);
+      return NULL;
    }
+   return ScheduleCreate(type, values[0], values[1]);
+}
 
-   #ifdef DEBUG
-   cerr << "DEBUG Python::dateblock('" << str
-      << "', isc=" << (string) (isc?"y":"n")
-      << ",block=" << (string) (block?"y":"n") << endl;
-   #endif
+#if PY_VERSION_HEX >= 0x03090000
+/* The same as the above without a tuple (and dict) being built first.
+ */
+static PyObject* Schedule_vectorcall(PyObject *type, PyObject *const *args,
+                                     size_t nargsf, PyObject *kwnames)
+{
+   PyObject *values[] = {NULL, Py_False};
+   if(!ParseArgs("Schedule", args, PyVectorcall_NARGS(nargsf), kwnames,
+                 NULL, ScheduleKwlist, 1, values))
+   {
+      return NULL;
+   }
+   return ScheduleCreate((PyTypeObject *)type, values[0], values[1]);
+}
+#endif
 
-   if(!Date::CronValid(str, isc))
+static void Schedule_dealloc(ScheduleObject *self)
+{
+   delete self->cron;
+   Py_XDECREF(self->pCronObj);
+   Py_XDECREF(self->pIscObj);
+   Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject* Schedule_repr(ScheduleObject *self)
+{
+   PyObject *pCronRepr = PyObject_Repr(self->pCronObj);
+   if(pCronRepr == NULL)
    {
-      // Raise SyntaxError Exception
-      PyErr_SetString(PyExc_SyntaxError,
-            "The cron specified is not formatted correctly.");
       return NULL;
    }
 
-   dObjFinish = dObjStart.Cron(str, isc);
+#ifdef IS_PY3K
+   PyObject *pRepr = PyUnicode_FromFormat("Schedule(%U, isc=%s)",
+         pCronRepr, (self->pIscObj == Py_True) ? "True" : "False");
+#else
+   PyObject *pRepr = PyString_FromFormat("Schedule(%s, isc=%s)",
+         PyString_AsString(pCronRepr),
+         (self->pIscObj == Py_True) ? "True" : "False");
+#endif
+   Py_DECREF(pCronRepr);
+   return pRepr;
+}
 
-   if(block && dObjFinish.Time() > dObjRef.Time())
+/* Schedule.next(ref=None): the next moment in time (after ref, or now)
+ * that matches the schedule.
+ */
+static PyObject* Schedule_next(ScheduleObject *self, PY_ARGS)
+{
+   static const char *const kwlist[] = {"ref", NULL};
+   PyObject *values[] = {NULL};
+   if(!PY_PARSE_ARGS("next", kwlist, 0, values))
+   {
+      return NULL;
+   }
+
+   PyObject *pDateObj = values[0];
+
+   Date dObjRef;
+   if(pDateObj != NULL && !RefToDate(pDateObj, dObjRef))
+   {
+      return NULL;
+   }
+
+   time_t tNext;
+   bool isFound;
+   Py_BEGIN_ALLOW_THREADS
+   isFound = self->cron->Next(dObjRef.Time(), tNext);
+   Py_END_ALLOW_THREADS
+   if(!isFound)
+   {
+      PyErr_SetString(PyExc_ValueError,
+            "No moment in time matches the cron specified.");
+      return NULL;
+   }
+   return DateToPy(Date(tNext));
+}
+
+/* Schedule.prev(ref=None): the last moment in time (before ref, or now)
+ * that matched the schedule.
+ */
+static PyObject* Schedule_prev(ScheduleObject *self, PY_ARGS)
+{
+   static const char *const kwlist[] = {"ref", NULL};
+   PyObject *values[] = {NULL};
+   if(!PY_PARSE_ARGS("prev", kwlist, 0, values))
+   {
+      return NULL;
+   }
+
+   PyObject *pDateObj = values[0];
+
+   Date dObjRef;
+   if(pDateObj != NULL && !RefToDate(pDateObj, dObjRef))
+   {
+      return NULL;
+   }
+
+   time_t tPrev;
+   bool isFound;
+   Py_BEGIN_ALLOW_THREADS
+   isFound = self->cron->Prev(dObjRef.Time(), tPrev);
+   Py_END_ALLOW_THREADS
+   if(!isFound)
+   {
+      PyErr_SetString(PyExc_ValueError,
+            "No moment in time matches the cron specified.");
+      return NULL;
+   }
+   return DateToPy(Date(tPrev));
+}
+
+/* Schedule.iter(start=None): an iterator over every moment in time (after
+ * start, or now) that matches the schedule.
+ */
+static PyObject* Schedule_iter(ScheduleObject *self, PY_ARGS)
+{
+   static const char *const kwlist[] = {"start", NULL};
+   PyObject *values[] = {NULL};
+   if(!PY_PARSE_ARGS("iter", kwlist, 0, values))
+   {
+      return NULL;
+   }
+
+   PyObject *pDateObj = values[0];
+
+   Date dObjStart;
+   if(pDateObj != NULL && !RefToDate(pDateObj, dObjStart))
+   {
+      return NULL;
+   }
+
+   ScheduleIterObject *pIter = PyObject_New(ScheduleIterObject,
+                                            &ScheduleIterType);
+   if(pIter == NULL)
+   {
+      return NULL;
+   }
+
+   Py_INCREF(self);
+   pIter->pSchedule = self;
+   pIter->tRef = dObjStart.Time();
+   pIter->index = 0;
+   pIter->count = 0;
+   return (PyObject *)pIter;
+}
+
+/* Schedule.wait(): blocks until the schedule is next due and returns that
+ * moment in time (or None if a signal cut it short).  Other threads are
+ * free to run while we wait.  Raises ValueError if nothing matches the
+ * schedule, which can also happen when the clock is set while we wait.
+ */
+static PyObject* Schedule_wait(ScheduleObject *self, PyObject *args)
+{
+   const Date dObjNow;
+   time_t tNext;
+   bool isFound;
+   Py_BEGIN_ALLOW_THREADS
+   isFound = self->cron->Next(dObjNow.Time(), tNext);
+   Py_END_ALLOW_THREADS
+   if(!isFound)
+   {
+      PyErr_SetString(PyExc_ValueError,
+            "No moment in time matches the cron specified.");
+      return NULL;
+   }
+
+   const unsigned long unslept = BlockForCron(*self->cron, tNext, isFound);
+   if(!isFound)
+   {
+      PyErr_SetString(PyExc_ValueError,
+            "No moment in time matches the cron specified.");
+      return NULL;
+   }
+   if(unslept)
    {
-      if(Block(dObjFinish.Time()-dObjRef.Time()))
+      // Give python a chance to raise KeyboardInterrupt and friends
+      if(PyErr_CheckSignals())
       {
-         // Simply put, if block is interupted by any
-         // means, we need to return this to the python
-         // tool calling it. Block() returns the amount of
-         // time still left to drift for; therfore we reached
-         // here because a non-zero value was returned
-         return Py_None;
+         return NULL;
       }
+      Py_RETURN_NONE;
    }
+   return DateToPy(Date(tNext));
+}
 
-   // Return Finish Date/Time
-   return PyDateTime_FromDateAndTime(dObjFinish.Year(),
-                                     dObjFinish.Month(),
-                                     dObjFinish.DOM(),
-                                     dObjFinish.Hour(),
-                                     dObjFinish.Min(),
-                                     dObjFinish.Sec(),
-                                     0);
+static PyMethodDef ScheduleMethods[] =
+{
+    {"next", (PyCFunction)Schedule_next, PY_METH_ARGS,
+                  "The next moment in time that matches the schedule"},
+    {"prev", (PyCFunction)Schedule_prev, PY_METH_ARGS,
+                  "The last moment in time that matched the schedule"},
+    {"iter", (PyCFunction)Schedule_iter, PY_METH_ARGS,
+                  "Iterate over the moments in time that match the schedule"},
+    {"wait", (PyCFunction)Schedule_wait, METH_NOARGS,
+                  "Block until the schedule is next due"},
+#ifdef IS_PY3K
+    {"next_many", (PyCFunction)Schedule_next_many, METH_O,
+                  "The next match after each of an array of epoch times"},
+#endif
+#ifdef HAS_WAIT_ASYNC
+    {"wait_async", (PyCFunction)Schedule_wait_async, METH_NOARGS,
+                  "Await the schedule being next due (asyncio)"},
+#endif
+    /* sentinel */
+    {NULL, NULL }
+};
+
+static PyMemberDef ScheduleMembers[] =
+{
+    {(char *)"cron", T_OBJECT, offsetof(ScheduleObject, pCronObj), READONLY,
+                  (char *)"The cron string"},
+    {(char *)"isc", T_OBJECT, offsetof(ScheduleObject, pIscObj), READONLY,
+                  (char *)"True if the cron string is in the ISC format"},
+    /* sentinel */
+    {NULL}
+};
+
+static PyTypeObject ScheduleType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "dateblock.Schedule",                      /* tp_name */
+    sizeof(ScheduleObject),                    /* tp_basicsize */
+    0,                                         /* tp_itemsize */
+    (destructor)Schedule_dealloc,              /* tp_dealloc */
+    0,                                         /* tp_print */
+    0,                                         /* tp_getattr */
+    0,                                         /* tp_setattr */
+    0,                                         /* tp_compare */
+    (reprfunc)Schedule_repr,                   /* tp_repr */
+    0,                                         /* tp_as_number */
+    0,                                         /* tp_as_sequence */
+    0,                                         /* tp_as_mapping */
+    0,                                         /* tp_hash */
+    0,                                         /* tp_call */
+    0,                                         /* tp_str */
+    0,                                         /* tp_getattro */
+    0,                                         /* tp_setattro */
+    0,                                         /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags */
+    "A cron string parsed once for repeated use", /* tp_doc */
+    0,                                         /* tp_traverse */
+    0,                                         /* tp_clear */
+    0,                                         /* tp_richcompare */
+    0,                                         /* tp_weaklistoffset */
+    0,                                         /* tp_iter */
+    0,                                         /* tp_iternext */
+    ScheduleMethods,                           /* tp_methods */
+    ScheduleMembers,                           /* tp_members */
+    0,                                         /* tp_getset */
+    0,                                         /* tp_base */
+    0,                                         /* tp_dict */
+    0,                                         /* tp_descr_get */
+    0,                                         /* tp_descr_set */
+    0,                                         /* tp_dictoffset */
+    0,                                         /* tp_init */
+    0,                                         /* tp_alloc */
+    Schedule_new,                              /* tp_new */
+};
+
+/* Return the statistics of the cache of parsed cron strings as a dictionary
+ * (hits, misses, size and capacity).
+ */
+static PyObject* cache_info(PyObject *self, PyObject *args)
+{
+   const CronCache &cache = CronCache::Global();
+   return Py_BuildValue("{s:k,s:k,s:n,s:n}",
+                        "hits", cache.Hits(),
+                        "misses", cache.Misses(),
+                        "size", (Py_ssize_t)cache.Size(),
+                        "capacity", (Py_ssize_t)cache.Capacity());
+}
+
+/* Empty the cache of parsed cron strings (and reset its statistics).
+ */
+static PyObject* cache_clear(PyObject *self, PyObject *args)
+{
+   CronCache::Global().Clear();
+   Py_RETURN_NONE;
 }
 
 /* Python Method Table.
  */
 static PyMethodDef CronMethods[] =
 {
-    {"dateblock", (PyCFunction)dateblock, METH_VARARGS|METH_KEYWORDS,
+    {"dateblock", (PyCFunction)dateblock, PY_METH_ARGS,
                   "Cron like blocking function"},
+#ifdef IS_PY3K
+    {"next_many", (PyCFunction)next_many, PY_METH_ARGS,
+                  "The next match after each of an array of epoch times"},
+#endif
+#ifdef HAS_WAIT_ASYNC
+    {"wait_async", (PyCFunction)wait_async, PY_METH_ARGS,
+                  "Await the next match of a cron (asyncio)"},
+#endif
+    {"cache_info", (PyCFunction)cache_info, METH_NOARGS,
+                  "Statistics of the parsed cron string cache"},
+    {"cache_clear", (PyCFunction)cache_clear, METH_NOARGS,
+                  "Empty the parsed cron string cache"},
     /* sentinel */
     {NULL, NULL }
 };
 
-/* Register the method table.
+/* Adds the Schedule type and our constants to the module.
  */
-PyMODINIT_FUNC
-initdateblock()
+static int AddToModule(PyObject *m)
 {
-   PyObject *m;
-
-   m = Py_InitModule("dateblock", CronMethods);
+   Py_INCREF(&ScheduleType);
+   if(PyModule_AddObject(m, "Schedule", (PyObject *)&ScheduleType) < 0)
+   {
+      Py_DECREF(&ScheduleType);
+      return -1;
+   }
 
    /* Create Constants */
    PyModule_AddIntConstant(m, "SEC_MIN", Date::T_SEC_MIN);
@@ -647,5 +2371,91 @@ initdateblock()
    PyModule_AddIntConstant(m, "DOW_MAX", Date::T_DOW_MAX);
    PyModule_AddIntConstant(m, "DRIFT_MIN", Date::T_DRIFT_MIN);
    PyModule_AddIntConstant(m, "DRIFT_MAX", Date::T_DRIFT_MAX);
+   return 0;
+}
+
+/* Readies our types (only the first call does anything).
+ */
+static int ReadyTypes()
+{
+#if PY_VERSION_HEX >= 0x03090000
+   ScheduleType.tp_vectorcall = Schedule_vectorcall;
+#endif
+   if(PyType_Ready(&ScheduleType) < 0 || PyType_Ready(&ScheduleIterType) < 0)
+   {
+      return -1;
+   }
+#ifdef HAS_WAIT_ASYNC
+   if(PyType_Ready(&AsyncWaitType) < 0)
+   {
+      return -1;
+   }
+#endif
+
+   if (!PyDateTimeAPI)
+      PyDateTime_IMPORT;
+   return PyDateTimeAPI ? 0 : -1;
+}
+
+#ifdef IS_PY3K
+/* Fills in the module once python has created it (multi-phase
+ * initialization; see PEP 489).
+ */
+static int dateblock_exec(PyObject *m)
+{
+   if(ReadyTypes() < 0)
+   {
+      return -1;
+   }
+   return AddToModule(m);
+}
+
+static PyModuleDef_Slot CronSlots[] =
+{
+    {Py_mod_exec, (void *)dateblock_exec},
+    /* sentinel */
+    {0, NULL}
+};
+
+static struct PyModuleDef CronModule =
+{
+    PyModuleDef_HEAD_INIT,
+    "dateblock",                               /* m_name */
+    "Cron like date blocking and calculations", /* m_doc */
+    0,                                         /* m_size */
+    CronMethods,                               /* m_methods */
+    CronSlots,                                 /* m_slots */
+    NULL,                                      /* m_traverse */
+    NULL,                                      /* m_clear */
+    NULL,                                      /* m_free */
+};
+
+/* Register the method table.
+ */
+PyMODINIT_FUNC
+PyInit_dateblock(void)
+{
+   return PyModuleDef_Init(&CronModule);
 }
+#else
+/* Register the method table.
+ */
+PyMODINIT_FUNC
+initdateblock()
+{
+   PyObject *m;
+
+   if(ReadyTypes() < 0)
+   {
+      return;
+   }
+
+   m = Py_InitModule("dateblock", CronMethods);
+   if(m == NULL)
+   {
+      return;
+   }
+   AddToModule(m);
+}
+#endif
 #endif
@@ -37,6 +37,18 @@ void sigAlarmHandler(int signal);
 /// Blocks for a specified period (in seconds)
 unsigned long Block(unsigned long seconds);
 
+/// Blocks until a moment in time (the start of the second specified);
+/// returns the number of seconds left if it was cut short by a signal or
+/// because the wall clock was set (isClockSet is set in the latter case)
+unsigned long BlockUntil(const time_t tDeadline, bool &isClockSet);
+
+/// Starts a job (a shell command) without waiting for it
+void RunJob(const string& sJob);
+
+/// Blocks until each schedule in a file (or stdin) comes due, forever
+int RunCronTable(const string& sFile, bool isISC, bool isTest,
+                 bool isVerbose);
+
 /// ProgramDetails displays help information
 void ProgramDetails();
 
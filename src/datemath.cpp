@@ -25,6 +25,7 @@
 #include <string>
 #include <boost/program_options.hpp>
 #include "Date.h"
+#include "DateFormat.h"
 #include "datemath.h"
 
 namespace po = boost::program_options;
@@ -120,6 +121,62 @@ bool FindAndReplace(string &sourceString, const string &findString, const int &r
    return(foundAtLeastOne);
 }
 
+//--------------------------------------------------
+//
+//  Function: TransformStream
+//
+//------------------------------------------------
+size_t TransformStream(FILE *fIn, FILE *fOut, const DateFormat &inFormat,
+                       const DateFormat &outFormat, const DateOffset &offset)
+{
+   // The line buffer is grown (by getline) to fit the longest line and
+   // reused from then on; the results are rendered straight into szOut
+   char *szLine = NULL;
+   size_t lineSize = 0;
+   char szOut[256];
+   size_t errors = 0;
+   size_t lineNo = 0;
+   ssize_t len;
+   Date dObj;
+
+   while((len = getline(&szLine, &lineSize, fIn)) >= 0)
+   {
+      lineNo++;
+      while(len > 0 && (szLine[len - 1] == '\n' || szLine[len - 1] == '\r'))
+      {
+         len--;
+      }
+
+      if(!dObj.Parse(inFormat, szLine, (size_t)len))
+      {
+         fprintf(stderr, "Error: Could not read line %lu : '%.*s'\n",
+                 (unsigned long)lineNo, (int)len, szLine);
+         fputc('\n', fOut);
+         errors++;
+         continue;
+      }
+
+      dObj.Add(offset);
+
+      const size_t outLen = outFormat.Render(dObj.Tm(), dObj.Time(),
+                                             szOut, sizeof(szOut));
+      if(outLen < sizeof(szOut))
+      {
+         fwrite(szOut, 1, outLen, fOut);
+      }
+      else
+      {
+         // Too long for our buffer; this is rare enough to allocate for
+         const string sOut = outFormat.Render(dObj.Tm(), dObj.Time());
+         fwrite(sOut.data(), 1, sOut.size(), fOut);
+      }
+      fputc('\n', fOut);
+   }
+
+   free(szLine);
+   return errors;
+}
+
 int main(int argc, char **argv)
 {
    Date curTime;
@@ -146,6 +203,8 @@ int main(int argc, char **argv)
        ("months,m", po::value<long>(), "Specify the offset (+/-) in months.")
        ("years,y", po::value<long>(), "Specify the offset (+/-) in years.")
        ("format,f", po::value<string>(), "Specify the desired output format (see $>man date). The default is: %Y-%m-%d %H:%M:%S")
+       ("stdin,r", "Read one date per line from stdin (rather then using the current date/time) and write each of them out with the offsets applied.")
+       ("input-format,F", po::value<string>(), "Specify the format the dates read with --stdin are in (see $>man date). The default is seconds since the epoch: %s")
    ;
 
 
@@ -170,7 +229,8 @@ int main(int argc, char **argv)
       return 0;
    }
 
-   if (! ( (poVariablesMap.count("seconds")) ||
+   if (! ( (poVariablesMap.count("stdin")) ||
+         (poVariablesMap.count("seconds")) ||
          (poVariablesMap.count("minutes")) ||
          (poVariablesMap.count("hours")) ||
          (poVariablesMap.count("months")) ||
@@ -221,12 +281,34 @@ int main(int argc, char **argv)
       strFormat = poVariablesMap["format"].as<string>();
    }
 
-   curTime.AddYear(lYearOffset);
-   curTime.AddMonth(lMonthOffset);
-   curTime.AddDOM(lDayOffset);
-   curTime.AddHour(lHourOffset);
-   curTime.AddMin(lMinOffset);
-   curTime.AddSec(lSecOffset);
+   // Every offset is applied in one step; see Date::Add()
+   DateOffset offset;
+   offset.years = lYearOffset;
+   offset.months = lMonthOffset;
+   offset.days = lDayOffset;
+   offset.hours = lHourOffset;
+   offset.minutes = lMinOffset;
+   offset.seconds = lSecOffset;
+
+   if (poVariablesMap.count("stdin"))
+   {
+      string strInFormat = "%s";
+      if ((poVariablesMap.count("input-format")))
+      {
+         strInFormat = poVariablesMap["input-format"].as<string>();
+      }
+
+      // Both formats are parsed once up front and stdout is written a
+      // (large) block at a time rather then a line at a time
+      static char outBuffer[1 << 16];
+      setvbuf(stdout, outBuffer, _IOFBF, sizeof(outBuffer));
+      const size_t errors = TransformStream(stdin, stdout,
+            DateFormat(strInFormat), DateFormat(strFormat), offset);
+      fflush(stdout);
+      return errors ? 1 : 0;
+   }
+
+   curTime.Add(offset);
 
    printf("%s\n",curTime.Str(strFormat).c_str());
    return 0;
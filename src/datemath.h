@@ -18,7 +18,10 @@
 */
 #ifndef _DATE_MATH_H_
 #define _DATE_MATH_H_
+#include <stdio.h>
 #include <sstream>
+#include "Date.h"
+#include "DateFormat.h"
 
 
 #define  AUTHOR       "Chris Caron <lead2gold@gmail.com>"
@@ -62,4 +65,20 @@ bool FindAndReplace(string &sourceString,
       const int &replaceNum,
       int width = 1 ,
       char fill = '0' );
+
+/// TransformStream reads one date per line from fIn, moves it by the
+/// offset specified and writes it out to fOut a line at a time
+///
+/// \param[in] fIn The stream to read the dates from
+/// \param[in] fOut The stream to write the results to
+/// \param[in] inFormat The format each line is read in
+/// \param[in] outFormat The format each result is written in
+/// \param[in] offset What each date is moved by (see Date::Add())
+///
+/// \return the number of lines that could not be read; an empty line is
+/// written out in place of each so the output stays in step with the input
+size_t TransformStream(FILE *fIn, FILE *fOut,
+      const DateFormat &inFormat,
+      const DateFormat &outFormat,
+      const DateOffset &offset);
 #endif
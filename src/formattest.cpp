@@ -0,0 +1,268 @@
+/*
+ Datetools provide a method of manipulating and working dates and times.
+ Copyright (C) 2013-2018 Chris Caron <lead2gold@gmail.com>
+
+ This file is part of Datetools.  Datetools is free software; you can
+ redistribute it and/or modify it under the terms of the GNU General Public
+ License as published by the Free Software Foundation; either version 2 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include <stdlib.h>
+#include <time.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Date.h"
+#include "DateFormat.h"
+using namespace std;
+
+/*
+ * Every format below pins the date down completely so that whatever Str()
+ * writes with it must Parse() back into a date that Str() writes the same
+ * way.  Between them they use every field Str() supports (the composite
+ * ones included).
+ */
+const char *round_trip[] =
+{
+   "%Y-%m-%d %H:%M:%S",
+   "%a %A %b %B %d %Y %H:%M:%S",
+   "%C%y-%m-%d %H:%M:%S",
+   "%y-%m-%d %H:%M:%S",
+   "%Y-%m-%d %I:%M:%S %p",
+   "%Y-%m-%d %l:%M:%S %P",
+   "%Y-%m-%d %k:%M:%S",
+   "%Y %j %H:%M:%S",
+   "%Y-%m-%d %H:%M:%S %u %U %w",
+   "%s",
+   "%c",
+   "%D %T",
+   "%Y-%m-%d %r",
+   "%Y-%m-%d %R:%S",
+   "%Y-%m-%d%t%X",
+   "%Y%m%d%H%M%S",
+};
+
+/*
+ * Dates that sit on the edges of the fields (midnight, noon, the last day
+ * of a leap year, ...) as seconds since the epoch; they are tested along
+ * with a set of random ones.
+ */
+const time_t edge_dates[] =
+{
+   0,               /* 1970-01-01 00:00:00 UTC */
+   951782400,       /* 2000-02-29 00:00:00 UTC */
+   978220799,       /* 2000-12-31 23:59:59 UTC */
+   1072958400,      /* 2004-01-01 12:00:00 UTC */
+   1104494400,      /* 2004-12-31 12:00:00 UTC */
+   2147483647,      /* 2038-01-19 03:14:07 UTC */
+   2147483648LL,    /* one second later */
+   3061065599LL,    /* 2066-12-31 23:59:59 UTC */
+};
+
+/*
+ * The pieces random formats are built from for the differential test; every
+ * field and composite, literal text, stray '%'s and specifiers Str() doesn't
+ * know.
+ */
+const char *format_pieces[] =
+{
+   "%a", "%A", "%b", "%B", "%C", "%d", "%H", "%I", "%j", "%k", "%l", "%m",
+   "%M", "%p", "%P", "%S", "%s", "%u", "%U", "%w", "%y", "%Y",
+   "%c", "%D", "%r", "%R", "%T", "%t", "%n", "%h", "%x", "%X",
+   "%", "%%", "%q", "%Z", "-", ":", "/", " ", "a", "Y", "at ",
+};
+
+const char dayAbbreva[7][4] =
+   {"Sun","Mon","Tue","Wed","Thu","Fri","Sat"};
+const int Sun2Mon[7] =
+   {7,1,2,3,4,5,6};
+const char dayOfWeek[7][10] =
+   {"Sunday","Monday","Tuesday","Wednesday","Thursday","Friday","Saturday"};
+const char monAbbrev[12][4] =
+   {"Jan","Feb","Mar","Apr","May","Jun","Jul","Aug","Sep","Oct","Nov","Dec"};
+const char monOfYear[12][10] =
+   {"January","February","March","April","May","June","July","August","September","October","November","December"};
+
+void FindAndReplace(string &sourceString, const string &findString,
+      const string &replaceString)
+{
+   string::size_type findStringLoc = 0;
+   while ((findStringLoc = sourceString.find(findString, findStringLoc)) != string::npos)
+   {
+      sourceString.replace(findStringLoc, findString.length(), replaceString);
+      findStringLoc += replaceString.length();
+   }
+}
+
+void FindAndReplace(string &sourceString, const string &findString,
+      const int64_t replaceNum, int width = 1, char fill = '0')
+{
+   stringstream out;
+   out << setw(width) << setfill(fill) << (long long)replaceNum;
+   FindAndReplace(sourceString, findString, out.str());
+}
+
+/*
+ * Renders a date one specifier at a time over the whole format, the way
+ * Date::Str() always has; the compiled DateFormat must write exactly the
+ * same thing.
+ */
+const string PassByPass(const Date& d, string strFormat)
+{
+   const struct tm& tmVal = d.Tm();
+   const int hour12 = (tmVal.tm_hour % 12) ? (tmVal.tm_hour % 12) : 12;
+
+   FindAndReplace(strFormat,"%c","%a %b %d %H:%M:%S %Y");
+   FindAndReplace(strFormat,"%D","%m/%d/%y");
+   FindAndReplace(strFormat,"%r","%H:%M:%S %p");
+   FindAndReplace(strFormat,"%R","%H:%M");
+   FindAndReplace(strFormat,"%T","%H:%M:%S");
+   FindAndReplace(strFormat,"%t","\t");
+   FindAndReplace(strFormat,"%n","\n");
+   FindAndReplace(strFormat,"%h","\n");
+   FindAndReplace(strFormat,"%x","%M/%d/%y");
+   FindAndReplace(strFormat,"%X","%H/%M/%S");
+
+   stringstream ss;
+   ss << (tmVal.tm_year+1900);
+   const string strYear = ss.str();
+
+   FindAndReplace(strFormat,"%a",dayAbbreva[tmVal.tm_wday]);
+   FindAndReplace(strFormat,"%A",dayOfWeek[tmVal.tm_wday]);
+   FindAndReplace(strFormat,"%b",monAbbrev[tmVal.tm_mon]);
+   FindAndReplace(strFormat,"%B",monOfYear[tmVal.tm_mon]);
+   FindAndReplace(strFormat,"%C",strYear.substr(0,2));
+   FindAndReplace(strFormat,"%d",tmVal.tm_mday,2);
+   FindAndReplace(strFormat,"%H",tmVal.tm_hour,2);
+   FindAndReplace(strFormat,"%I",hour12,2);
+   FindAndReplace(strFormat,"%j",tmVal.tm_yday + 1,3);
+   FindAndReplace(strFormat,"%k",tmVal.tm_hour,2,' ');
+   FindAndReplace(strFormat,"%l",hour12,2,' ');
+   FindAndReplace(strFormat,"%m",(tmVal.tm_mon+1),2);
+   FindAndReplace(strFormat,"%M",(tmVal.tm_min),2);
+   FindAndReplace(strFormat,"%p",((tmVal.tm_hour>11)?"PM":"AM"));
+   FindAndReplace(strFormat,"%P",((tmVal.tm_hour>11)?"pm":"am"));
+   FindAndReplace(strFormat,"%S",(tmVal.tm_sec),2);
+   FindAndReplace(strFormat,"%s",(int64_t)d.Time(),2);
+   FindAndReplace(strFormat,"%u",Sun2Mon[tmVal.tm_wday],1);
+   FindAndReplace(strFormat,"%U",tmVal.tm_yday%7,2);
+   FindAndReplace(strFormat,"%w",tmVal.tm_wday);
+   FindAndReplace(strFormat,"%y",strYear.substr(2,2));
+   FindAndReplace(strFormat,"%Y",(tmVal.tm_year)+1900,4);
+
+   return strFormat;
+}
+
+/* Returns false (and says why) if Str() doesn't write what PassByPass() does */
+bool SameAsPassByPass(const Date& d, const string& sFormat)
+{
+   const string sExpected = PassByPass(d, sFormat);
+   const string sOut = d.Str(sFormat);
+   if(sOut != sExpected)
+   {
+      cerr << "FATAL: '" << sFormat << "' wrote '" << sOut
+           << "' instead of '" << sExpected << "' for " << d.Time() << endl;
+      return false;
+   }
+
+   // The buffer overload truncates but always reports the full length
+   char szOut[8];
+   const size_t len = DateFormat(sFormat).Render(d.Tm(), d.Time(),
+                                                  szOut, sizeof(szOut));
+   if(len != sExpected.size() ||
+      sExpected.compare(0, sizeof(szOut) - 1, szOut) != 0)
+   {
+      cerr << "FATAL: '" << sFormat << "' rendered '" << szOut
+           << "' (" << len << ") into a short buffer for " << d.Time()
+           << endl;
+      return false;
+   }
+   return true;
+}
+
+/* Returns false (and says why) if d doesn't survive Str() then Parse() */
+bool RoundTrip(const Date& d, const char *szFormat)
+{
+   const DateFormat format(szFormat);
+   const string sOut = d.Str(format);
+
+   Date dParsed(d);
+   dParsed.Set((time_t)12345);
+   if(!dParsed.Parse(format, sOut))
+   {
+      cerr << "FATAL: '" << szFormat << "' could not read back '"
+           << sOut << "'" << endl;
+      return false;
+   }
+
+   const string sBack = dParsed.Str(format);
+   if(sBack != sOut)
+   {
+      cerr << "FATAL: '" << szFormat << "' wrote '" << sOut
+           << "' which was read back as '" << sBack << "'" << endl;
+      return false;
+   }
+   return true;
+}
+
+int main(int argc, char **argv)
+{
+   unsigned failures = 0;
+
+   // A fixed seed keeps every run the same
+   srand(20120305);
+
+   for (unsigned i=0; i < sizeof(round_trip)/sizeof(round_trip[0]); i++)
+   {
+      for (unsigned j=0; j < sizeof(edge_dates)/sizeof(edge_dates[0]); j++)
+      {
+         failures += !RoundTrip(Date(edge_dates[j]), round_trip[i]);
+      }
+
+      // Random dates between 1970 and 2067 (the years %y can read back)
+      for (unsigned j=0; j < 2000; j++)
+      {
+         const time_t tVal = (time_t)(((int64_t)rand() << 16 ^ rand()) %
+                                      3061065600LL);
+         failures += !RoundTrip(Date(tVal), round_trip[i]);
+      }
+   }
+
+   if(failures)
+   {
+      cerr << failures << " dates did not survive Str() then Parse()"
+           << endl;
+      return 1;
+   }
+
+   // Random formats over random dates between 1900 and 2200
+   const unsigned pieces = sizeof(format_pieces)/sizeof(format_pieces[0]);
+   for (unsigned i=0; i < 20000; i++)
+   {
+      string sFormat;
+      for (int count = 1 + rand() % 8; count > 0; count--)
+         sFormat += format_pieces[rand() % pieces];
+
+      const time_t tVal = (time_t)(((int64_t)rand() << 16 ^ rand()) %
+                                   9467193600LL - 2208988800LL);
+      failures += !SameAsPassByPass(Date(tVal), sFormat);
+   }
+
+   if(failures)
+   {
+      cerr << failures << " formats were not written the way Str() has "
+           << "always written them" << endl;
+      return 1;
+   }
+   return 0;
+}
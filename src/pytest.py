@@ -23,24 +23,39 @@ from datetime import datetime
 from dateblock import dateblock
 from datetime import date
 from datetime import time
+import itertools
 # Support python datetime object
-print dateblock("*/1", ref=datetime(2000, 5, 3, 10, 10, 0))
+print(dateblock("*/1", ref=datetime(2000, 5, 3, 10, 10, 0)))
 # Support python date object
-print dateblock("*/1", ref=date(2000, 5, 3))
+print(dateblock("*/1", ref=date(2000, 5, 3)))
 # Support python time object
-print dateblock("*/1", ref=time(20, 5, 3), block=False)
+print(dateblock("*/1", ref=time(20, 5, 3), block=False))
 # Time equals 'now'
-print dateblock("*/1", ref=None, block=False)
+print(dateblock("*/1", ref=None, block=False))
 # Epoch Time
-print dateblock("*/1", ref=7999434323, block=False)
+print(dateblock("*/1", ref=7999434323, block=False))
 # Drift Time
-print dateblock("*/10 +5", ref=7999434323, block=False)
+print(dateblock("*/10 +5", ref=7999434323, block=False))
 # Blocking should never be possible if the time is in the past
-print dateblock("*/10 +7", ref=999434323, block=True)
+print(dateblock("*/10 +7", ref=999434323, block=True))
 # Drifting inline
-print dateblock("*/10 +5", ref=date(2000, 1, 1), block=False)
+print(dateblock("*/10 +5", ref=date(2000, 1, 1), block=False))
 # Drifting inline (with option specified, inline should over-ride)
 # Drifting without use of +
-print dateblock("*/10 * * * * * 5", ref=date(2000, 2, 1), block=False)
+print(dateblock("*/10 * * * * * 5", ref=date(2000, 2, 1), block=False))
 # Drifting with multiple options specified
-print dateblock("* 10 +5,8", ref=date(2000, 3, 1), block=False)
+print(dateblock("* 10 +5,8", ref=date(2000, 3, 1), block=False))
+# Schedules are only parsed once and can be asked for matches over and over
+from dateblock import Schedule
+schedule = Schedule("* 10 +5,8")
+print(schedule.next(ref=date(2000, 3, 1)))
+print(schedule.prev(ref=date(2000, 3, 1)))
+print([str(d) for d in itertools.islice(schedule.iter(date(2000, 3, 1)), 3)])
+# The next match after each of a column of epoch times in a single call
+# (anything holding 64 bit integers; array.array('q'), NumPy, ...)
+import sys
+if sys.version_info[0] >= 3:
+    from array import array
+    from dateblock import next_many
+    print(list(next_many("0 /15", array('q', [7999434323, 7999434324]))))
+    print(list(schedule.next_many(array('q', [7999434323]))))